@@ -0,0 +1,227 @@
+#ifndef __BENCHMARK_H__
+#define __BENCHMARK_H__
+
+#include <worm/EventChannel.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace bench {
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    worm::DispatchType dispatchType;
+
+    size_t handlerCount;
+
+    size_t payloadSize;
+
+    size_t producerCount;
+
+    // QUEUED only - the event count budget of one DispatchAllQueued call
+    size_t eventsPerCycle;
+
+    size_t eventCount;
+};
+
+struct Result {
+    Config config;
+
+    double seconds;
+
+    double eventsPerSecond;
+
+    // QUEUED only - the number of DispatchAllQueued calls which handled at least one event
+    size_t dispatchCycles;
+
+    // nanoseconds
+    uint64_t p50;
+
+    uint64_t p99;
+
+    uint64_t p999;
+};
+
+template <size_t PayloadSize>
+struct Event {
+    Clock::time_point postTime;
+
+    std::array<char, PayloadSize> payload;
+};
+
+template <size_t PayloadSize>
+class Handler {
+public:
+    explicit Handler(std::vector<uint64_t>* latencies)
+        : m_latencies{ latencies }
+    {
+    }
+
+    void operator()(const Event<PayloadSize>& event)
+    {
+        // touch the payload so the copies can not be optimized out, SYNC producers call the handler concurrently
+        const auto handledCount{ m_handledCount.fetch_add(1, std::memory_order_release) };
+        m_checksum.fetch_add(static_cast<unsigned char>(event.payload[handledCount % PayloadSize]), std::memory_order_relaxed);
+
+        if (m_latencies) {
+            m_latencies->push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - event.postTime).count()));
+        }
+    }
+
+    size_t GetHandledCount() const
+    {
+        return m_handledCount.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<uint64_t>* m_latencies;
+
+    std::atomic<size_t> m_handledCount{ 0 };
+
+    std::atomic<uint64_t> m_checksum{ 0 };
+};
+
+inline const char* ToString(const worm::DispatchType dispatchType)
+{
+    switch (dispatchType) {
+    case worm::DispatchType::ASYNC:
+        return "ASYNC";
+    case worm::DispatchType::QUEUED:
+        return "QUEUED";
+    case worm::DispatchType::ASYNC_DETACHED:
+        return "ASYNC_DETACHED";
+    default:
+        return "SYNC";
+    }
+}
+
+inline uint64_t Percentile(const std::vector<uint64_t>& sortedSamples, const double percentile)
+{
+    if (sortedSamples.empty()) {
+        return 0;
+    }
+    const auto index{ static_cast<size_t>(percentile * static_cast<double>(sortedSamples.size())) };
+    return sortedSamples[std::min(index, sortedSamples.size() - 1)];
+}
+
+// SYNC latency is the duration of Post, QUEUED and ASYNC latency is the time from Post to the first handler call.
+template <size_t PayloadSize>
+Result Run(Config config)
+{
+    using EventType = Event<PayloadSize>;
+
+    config.payloadSize = PayloadSize;
+    config.eventCount -= config.eventCount % config.producerCount;
+
+    const auto eventsPerProducer{ config.eventCount / config.producerCount };
+    const bool measurePost{ config.dispatchType == worm::DispatchType::SYNC };
+
+    // handlers of one event type are not called concurrently except for SYNC which is measured by the producers
+    std::vector<uint64_t> handlerLatencies;
+    handlerLatencies.reserve(measurePost ? 0 : config.eventCount);
+
+    std::vector<std::unique_ptr<Handler<PayloadSize>>> handlers;
+    std::vector<worm::SubscriptionToken> tokens;
+    for (size_t i = 0; i < config.handlerCount; ++i) {
+        handlers.emplace_back(std::make_unique<Handler<PayloadSize>>(i == 0 && !measurePost ? &handlerLatencies : nullptr));
+        tokens.push_back(worm::EventChannel::Add<EventType>(*handlers.back()));
+    }
+
+    std::vector<std::vector<uint64_t>> postLatencies(config.producerCount);
+    std::atomic<bool> start{ false };
+
+    std::vector<std::thread> producers;
+    for (size_t producerIndex = 0; producerIndex < config.producerCount; ++producerIndex) {
+        producers.emplace_back([&, producerIndex]() {
+            auto& latencies{ postLatencies[producerIndex] };
+            latencies.reserve(measurePost ? eventsPerProducer : 0);
+
+            EventType event{};
+            event.payload.fill(static_cast<char>(producerIndex));
+
+            while (!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            for (size_t i = 0; i < eventsPerProducer; ++i) {
+                event.postTime = Clock::now();
+                worm::EventChannel::Post(event, config.dispatchType);
+
+                if (measurePost) {
+                    latencies.push_back(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - event.postTime).count()));
+                }
+            }
+        });
+    }
+
+    const auto startTime{ Clock::now() };
+    start.store(true, std::memory_order_release);
+
+    size_t dispatchCycles{ 0 };
+    if (config.dispatchType == worm::DispatchType::QUEUED) {
+        // the producers are not throttled, the backlog is drained by budgeted dispatch cycles
+        const auto budget{ worm::DispatchBudget::ForEventCount(config.eventsPerCycle) };
+        while (handlers[0]->GetHandledCount() < config.eventCount) {
+            if (worm::EventChannel::DispatchAllQueued(budget) == 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            ++dispatchCycles;
+        }
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    if (config.dispatchType == worm::DispatchType::ASYNC) {
+        worm::EventChannel::DispatchAllAsync();
+    }
+
+    const std::chrono::duration<double> duration{ Clock::now() - startTime };
+
+    for (const auto& token : tokens) {
+        worm::EventChannel::Remove<EventType>(token);
+    }
+
+    std::vector<uint64_t> samples{ std::move(handlerLatencies) };
+    for (const auto& latencies : postLatencies) {
+        samples.insert(samples.end(), latencies.begin(), latencies.end());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    return { config, duration.count(), static_cast<double>(config.eventCount) / duration.count(), dispatchCycles, Percentile(samples, 0.5), Percentile(samples, 0.99), Percentile(samples, 0.999) };
+}
+
+inline void WriteJson(std::ostream& out, const std::vector<Result>& results)
+{
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result{ results[i] };
+        const auto& config{ result.config };
+        out << "    {"
+            << "\"dispatchType\": \"" << ToString(config.dispatchType) << "\", "
+            << "\"handlerCount\": " << config.handlerCount << ", "
+            << "\"payloadSize\": " << config.payloadSize << ", "
+            << "\"producerCount\": " << config.producerCount << ", "
+            << "\"eventsPerCycle\": " << config.eventsPerCycle << ", "
+            << "\"eventCount\": " << config.eventCount << ", "
+            << "\"seconds\": " << result.seconds << ", "
+            << "\"eventsPerSecond\": " << result.eventsPerSecond << ", "
+            << "\"dispatchCycles\": " << result.dispatchCycles << ", "
+            << "\"latencyNs\": {\"p50\": " << result.p50 << ", \"p99\": " << result.p99 << ", \"p999\": " << result.p999 << "}"
+            << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+} // namespace bench
+
+#endif
@@ -0,0 +1,80 @@
+#include "Benchmark.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+void PrintUsage()
+{
+    std::cerr << "Usage: Benchmarks [--events <COUNT>] [--output <FILE>]" << std::endl;
+}
+} // namespace
+
+// Results are written as JSON to the output file or to the standard output.
+int main(int argc, char** argv)
+{
+    size_t eventCount{ 100000 };
+    const char* outputPath{ nullptr };
+
+    for (int i = 1; i < argc; i += 2) {
+        if (std::strcmp(argv[i], "--events") != 0 && std::strcmp(argv[i], "--output") != 0) {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+
+        if (i + 1 == argc) {
+            std::cerr << "Missing value of option " << argv[i] << std::endl;
+            PrintUsage();
+            return EXIT_FAILURE;
+        }
+
+        if (std::strcmp(argv[i], "--events") == 0) {
+            char* end{ nullptr };
+            eventCount = std::strtoull(argv[i + 1], &end, 10);
+            if (*end != '\0' || eventCount == 0) {
+                std::cerr << "Invalid event count " << argv[i + 1] << std::endl;
+                PrintUsage();
+                return EXIT_FAILURE;
+            }
+        } else {
+            outputPath = argv[i + 1];
+        }
+    }
+
+    const worm::DispatchType dispatchTypes[]{ worm::DispatchType::SYNC, worm::DispatchType::QUEUED, worm::DispatchType::ASYNC };
+    const size_t handlerCounts[]{ 1, 8 };
+    const size_t producerCounts[]{ 1, 4 };
+    const size_t eventsPerCycles[]{ 64, 4096 };
+
+    std::vector<bench::Result> results;
+    for (const auto dispatchType : dispatchTypes) {
+        for (const auto handlerCount : handlerCounts) {
+            for (const auto producerCount : producerCounts) {
+                for (const auto eventsPerCycle : eventsPerCycles) {
+                    if (dispatchType != worm::DispatchType::QUEUED && eventsPerCycle != eventsPerCycles[0]) {
+                        continue;
+                    }
+
+                    bench::Config config{ dispatchType, handlerCount, 0, producerCount, dispatchType == worm::DispatchType::QUEUED ? eventsPerCycle : 0, eventCount };
+
+                    results.push_back(bench::Run<16>(config));
+                    results.push_back(bench::Run<1024>(config));
+
+                    std::cerr << "Finished " << bench::ToString(dispatchType) << " handlers=" << handlerCount << " producers=" << producerCount << " eventsPerCycle=" << config.eventsPerCycle << std::endl;
+                }
+            }
+        }
+    }
+
+    if (outputPath) {
+        std::ofstream out{ outputPath };
+        bench::WriteJson(out, results);
+    } else {
+        bench::WriteJson(std::cout, results);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -146,6 +146,9 @@ private:
 
 int main()
 {
+    // the loggers are not thread-safe and get LogEvent both SYNC and ASYNC
+    worm::EventChannel::SetSerializedDispatch<LogEvent>(true);
+
     StdOutLogger stdOutLogger;
     NetworkLogger networkLogger;
 
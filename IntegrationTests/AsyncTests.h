@@ -60,4 +60,28 @@ TEST(PublishSubscribeTest, HandleMultipleAsyncEvents2)
     }
 }
 
+TEST(PublishSubscribeTest, HandleMultipleDetachedEvents)
+{
+    ObjectWithHandler object;
+
+    const uint32_t eventCount{ 1000 };
+
+    auto getMessage = [](uint32_t i) {
+        return (std::stringstream{} << "Detached Message " << i).str();
+    };
+
+    // Post multiple detached asynchronous events
+    for (uint32_t i = 0; i < eventCount; ++i) {
+        TestEvent event{ getMessage(i) };
+        worm::EventChannel::Post(event, worm::DispatchType::ASYNC_DETACHED);
+    }
+
+    worm::EventChannel::DispatchAllAsync();
+
+    EXPECT_EQ(object.GetMessages().size(), eventCount);
+    for (uint32_t i = 0; i < eventCount; ++i) {
+        EXPECT_EQ(object.GetMessages()[i], getMessage(i));
+    }
+}
+
 #endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "SyncTests.h"
 #include "AsyncTests.h"
 #include "QueuedTests.h"
+#include "SharedMemoryTests.h"
 
 int main(int argc, char** argv)
 {
@@ -6,6 +6,7 @@
 #include <worm/EventChannel.h>
 
 #include <sstream>
+#include <thread>
 
 
 TEST(PublishSubscribeTest, HandleQueuedEvent)
@@ -74,4 +75,38 @@ TEST(PublishSubscribeTest, HandleMultipleQueuedEvents2)
     }
 }
 
+TEST(PublishSubscribeTest, HandleQueuedEventsFromMultipleThreads)
+{
+    ObjectWithHandler object;
+
+    const uint32_t producerCount{ 8 };
+    const uint32_t eventCount{ 1000 };
+
+    auto getMessage = [](uint32_t producer, uint32_t i) {
+        return (std::stringstream{} << "Queued Message " << producer << " " << i).str();
+    };
+
+    // Post queued events from multiple threads while the main thread keeps dispatching
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < producerCount; ++p) {
+        producers.emplace_back([&getMessage, p]() {
+            for (uint32_t i = 0; i < eventCount; ++i) {
+                worm::EventChannel::Post(TestEvent{ getMessage(p, i) }, worm::DispatchType::QUEUED);
+            }
+        });
+    }
+
+    while (object.GetMessages().size() < producerCount * eventCount / 2) {
+        worm::EventChannel::DispatchAllQueued();
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    worm::EventChannel::DispatchAllQueued();
+
+    EXPECT_EQ(object.GetMessages().size(), producerCount * eventCount);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#ifndef __SHARED_MEMORY_TESTS_H__
+#define __SHARED_MEMORY_TESTS_H__
+
+#include "Common.h"
+
+#include <worm/SharedMemoryTransport.h>
+
+#if WH_HAS_SHARED_MEMORY
+
+#include <sys/wait.h>
+
+#include <string>
+
+struct SharedTick {
+    int sequence;
+
+    double value;
+};
+
+TEST(PublishSubscribeTest, HandleEventsOfAnotherProcess)
+{
+    const std::string name{ "/wh_ticks_" + std::to_string(::getpid()) };
+    const int tickCount{ 10000 };
+
+    worm::EventBus bus{ 1 };
+    worm::SharedMemorySubscriber<SharedTick> subscriber{ bus, name, 64 };
+
+    const auto child{ ::fork() };
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        // Post the ticks to a bus of the child process, the ring is smaller than the ticks, so the publisher blocks
+        worm::EventBus childBus{ 1 };
+        worm::SharedMemoryPublisher<SharedTick> publisher{ childBus, name };
+        for (int i = 0; i < tickCount; ++i) {
+            childBus.Post(SharedTick{ i, i * 0.5 }, worm::DispatchType::QUEUED);
+            childBus.DispatchAllQueued();
+        }
+        ::_exit(0);
+    }
+
+    struct TickHandler {
+        void operator()(const SharedTick& tick)
+        {
+            EXPECT_EQ(tick.sequence, nextSequence);
+            EXPECT_EQ(tick.value, nextSequence * 0.5);
+            ++nextSequence;
+        }
+
+        int nextSequence{ 0 };
+    } handler;
+
+    auto token = bus.Add<SharedTick>(handler);
+    int status{ 0 };
+    bool exited{ false };
+    while (!exited) {
+        if (subscriber.Dispatch() == 0) {
+            // The ticks published right before the exit are still dispatched
+            exited = ::waitpid(child, &status, WNOHANG) == child;
+            std::this_thread::yield();
+        }
+    }
+    subscriber.Dispatch();
+    bus.Remove<SharedTick>(token);
+
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_EQ(handler.nextSequence, tickCount);
+}
+
+#endif
+
+#endif
@@ -1,11 +1,26 @@
 #include "worm/detail/SingletonTests.h"
-#include "worm/detail/ThreadPoolTests.h"
 #include "worm/detail/RingBufferTests.h"
+#include "worm/detail/MpscQueueTests.h"
+#include "worm/detail/WorkStealingExecutorTests.h"
+#include "worm/detail/StrandTests.h"
+#include "worm/detail/EpochDomainTests.h"
+#include "worm/detail/DelegateTests.h"
+#include "worm/detail/SlotMapTests.h"
+#include "worm/detail/ChannelMetricsTests.h"
+#include "worm/detail/BoundedQueueTests.h"
+#include "worm/detail/CoalescingQueueTests.h"
+#include "worm/detail/CycleArenaTests.h"
+#include "worm/detail/ProducerBufferedQueueTests.h"
+#include "worm/detail/SharedMemoryRingTests.h"
+#include "worm/detail/EventLogTests.h"
+#include "worm/detail/TimerWheelTests.h"
 
 #include "worm/detail/EventChannelQueueManagerTests.h"
 #include "worm/detail/EventChannelQueueTests.h"
 
 #include "worm/EventChannelTests.h"
+#include "worm/EventBusTests.h"
+#include "worm/EventRecorderTests.h"
 #include "worm/EventHandlerTests.h"
 
 TEST(SampleTest, BasicAssertions)
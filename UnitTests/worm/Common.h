@@ -2,6 +2,7 @@
 #define __COMMON_H__
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -10,6 +11,48 @@ struct TestEvent {
     std::string message;
 };
 
+// Event which counts how many times it has been copied
+struct CopyCountingEvent {
+    CopyCountingEvent(const std::string& msg)
+        : message{ msg }
+    {
+    }
+
+    CopyCountingEvent(const CopyCountingEvent& other)
+        : message{ other.message }
+    {
+        ++copyCount;
+    }
+
+    CopyCountingEvent(CopyCountingEvent&& other) = default;
+
+    std::string message;
+
+    static inline std::atomic<uint32_t> copyCount{ 0 };
+};
+
+class CopyCountingHandler {
+public:
+    void operator()(const CopyCountingEvent& event)
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        m_messages.push_back(event.message);
+    }
+
+    std::vector<std::string> GetMessages() const
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        return m_messages;
+    }
+
+private:
+    std::vector<std::string> m_messages;
+
+    mutable std::mutex m_mutex;
+};
+
 class MockHandler {
 public:
     void operator()(const TestEvent& event)
@@ -0,0 +1,224 @@
+#ifndef __WORM_EVENT_BUS_TESTS_H__
+#define __WORM_EVENT_BUS_TESTS_H__
+
+#include "Common.h"
+
+#include <worm/EventChannel.h>
+#include <worm/EventHandler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST(EventBusTest, BusesAreIsolated)
+{
+    worm::EventBus bus1{ 1 };
+    worm::EventBus bus2{ 1 };
+
+    MockHandler handler1, handler2, defaultHandler;
+    bus1.Add<TestEvent>(handler1);
+    bus2.Add<TestEvent>(handler2);
+    auto defaultToken = worm::EventChannel::Add<TestEvent>(defaultHandler);
+
+    // Messages reach only the handlers of their bus
+    bus1.Post(TestEvent{ "Bus1 Message" });
+    bus2.Post(TestEvent{ "Bus2 Queued Message" }, worm::DispatchType::QUEUED);
+    EXPECT_EQ(handler1.GetMessages(), (std::vector<std::string>{ "Bus1 Message" }));
+    EXPECT_TRUE(handler2.GetMessages().empty());
+    EXPECT_TRUE(defaultHandler.GetMessages().empty());
+
+    // The dispatch of one bus does not drain the others
+    bus1.DispatchAllQueued();
+    worm::EventChannel::DispatchAllQueued();
+    EXPECT_TRUE(handler2.GetMessages().empty());
+
+    bus2.DispatchAllQueued();
+    EXPECT_EQ(handler2.GetMessages(), (std::vector<std::string>{ "Bus2 Queued Message" }));
+    EXPECT_TRUE(defaultHandler.GetMessages().empty());
+
+    // Only the channels of the bus are reported
+    const auto metrics = bus1.GetMetrics();
+    ASSERT_EQ(metrics.size(), 1);
+    EXPECT_EQ(metrics[0].postedCount, 1);
+
+    worm::EventChannel::Remove<TestEvent>(defaultToken);
+}
+
+TEST(EventBusTest, AsyncDispatchOnOwnWorkers)
+{
+    std::atomic<size_t> handledCount{ 0 };
+    std::thread::id handlerThread;
+
+    struct AsyncHandler {
+        void operator()(const TestEvent&)
+        {
+            threadId = std::this_thread::get_id();
+            handledCount.fetch_add(1);
+        }
+
+        std::atomic<size_t>& handledCount;
+
+        std::thread::id& threadId;
+    } handler{ handledCount, handlerThread };
+
+    {
+        worm::EventBus bus{ 2 };
+        {
+            worm::EventHandler<AsyncHandler, TestEvent> eventHandler{ bus, handler };
+
+            for (int i = 0; i < 100; ++i) {
+                bus.Post(TestEvent{ "Async Message" }, worm::DispatchType::ASYNC);
+            }
+            bus.DispatchAllAsync();
+            EXPECT_EQ(handledCount.load(), 100);
+            EXPECT_NE(handlerThread, std::this_thread::get_id());
+        }
+
+        // Pending detached messages are handled before the bus is destroyed
+        bus.Add<TestEvent>(handler);
+        bus.Post(TestEvent{ "Detached Message" }, worm::DispatchType::ASYNC_DETACHED);
+    }
+    EXPECT_EQ(handledCount.load(), 101);
+}
+
+TEST(EventBusTest, BudgetedQueuedDispatch)
+{
+    struct FirstEvent {
+        int value;
+    };
+
+    struct SecondEvent {
+        int value;
+    };
+
+    struct CountingHandler {
+        void operator()(const FirstEvent&)
+        {
+            ++firstCount;
+        }
+
+        void operator()(const SecondEvent&)
+        {
+            ++secondCount;
+        }
+
+        size_t firstCount{ 0 };
+
+        size_t secondCount{ 0 };
+    } handler;
+
+    worm::EventBus bus{ 1 };
+    bus.Add<FirstEvent>(handler);
+    bus.Add<SecondEvent>(handler);
+
+    for (int i = 0; i < 100; ++i) {
+        bus.Post(FirstEvent{ i }, worm::DispatchType::QUEUED);
+        bus.Post(SecondEvent{ i }, worm::DispatchType::QUEUED);
+    }
+    bus.Post(FirstEvent{ 100 }, worm::DispatchType::QUEUED, worm::Priority::HIGH);
+    EXPECT_EQ(bus.GetQueuedBacklog(), 201);
+
+    // The higher priority goes first, then the channels take turns
+    EXPECT_EQ(bus.DispatchAllQueued(worm::DispatchBudget::ForEventCount(41)), 41);
+    EXPECT_EQ(handler.firstCount + handler.secondCount, 41);
+    EXPECT_GE(handler.secondCount, 16);
+    EXPECT_GE(handler.firstCount, 17);
+    EXPECT_EQ(bus.GetQueuedBacklog(), 160);
+
+    // A passed deadline dispatches nothing
+    EXPECT_EQ(bus.DispatchAllQueued(worm::DispatchBudget::ForDuration(std::chrono::nanoseconds{ 0 })), 0);
+
+    EXPECT_EQ(bus.DispatchAllQueued(worm::DispatchBudget::ForDuration(std::chrono::seconds{ 10 })), 160);
+    EXPECT_EQ(handler.firstCount, 101);
+    EXPECT_EQ(handler.secondCount, 100);
+    EXPECT_EQ(bus.GetQueuedBacklog(), 0);
+}
+
+TEST(EventBusTest, BudgetedDispatchLeavesRepostedEvents)
+{
+    struct RepostedEvent {
+        int generation;
+    };
+
+    worm::EventBus bus{ 1 };
+
+    std::vector<int> generations;
+    auto handler = [&](const RepostedEvent& event) {
+        generations.push_back(event.generation);
+        bus.Post(RepostedEvent{ event.generation + 1 }, worm::DispatchType::QUEUED);
+        bus.Post(RepostedEvent{ event.generation + 1 }, worm::DispatchType::QUEUED, worm::Priority::LOW);
+    };
+    bus.Add<RepostedEvent>(handler);
+
+    // The unlimited budget stops at the backlog of a priority at its turn, like the unbudgeted dispatch
+    for (int i = 0; i < 40; ++i) {
+        bus.Post(RepostedEvent{ 0 }, worm::DispatchType::QUEUED);
+    }
+    EXPECT_EQ(bus.DispatchAllQueued(worm::DispatchBudget{}), 80);
+    EXPECT_EQ(std::count(generations.begin(), generations.end(), 0), 40);
+    EXPECT_EQ(std::count(generations.begin(), generations.end(), 1), 40);
+    EXPECT_EQ(bus.GetQueuedBacklog(), 120);
+
+    generations.clear();
+    bus.DispatchAllQueued();
+    EXPECT_EQ(generations.size(), 200);
+}
+
+TEST(EventBusTest, DelayedPosting)
+{
+    worm::EventBus bus{ 1 };
+
+    MockHandler handler;
+    bus.Add<TestEvent>(handler);
+
+    bus.PostDelayed(TestEvent{ "Delayed Message" }, std::chrono::milliseconds{ 100 });
+    const auto cancelled = bus.PostDelayed(TestEvent{ "Cancelled Message" }, std::chrono::milliseconds{ 50 });
+    bus.PostAt(TestEvent{ "Past Message" }, std::chrono::steady_clock::now() - std::chrono::seconds{ 1 }, worm::DispatchType::SYNC);
+
+    // A deadline in the past is due on the next advance, the others have not passed yet
+    bus.AdvanceTimers();
+    EXPECT_EQ(handler.GetMessages(), (std::vector<std::string>{ "Past Message" }));
+
+    EXPECT_TRUE(bus.CancelTimer<TestEvent>(cancelled));
+    EXPECT_FALSE(bus.CancelTimer<TestEvent>(cancelled));
+
+    bus.DispatchAllQueued();
+    EXPECT_EQ(handler.GetMessages().size(), 1);
+
+    // The due QUEUED message is dispatched by the same DispatchAllQueued call
+    std::this_thread::sleep_for(std::chrono::milliseconds{ 150 });
+    bus.DispatchAllQueued();
+    EXPECT_EQ(handler.GetMessages(), (std::vector<std::string>{ "Past Message", "Delayed Message" }));
+}
+
+TEST(EventBusTest, PollAndWaitAsync)
+{
+    worm::EventBus bus{ 2 };
+
+    std::atomic<bool> isOpen{ false };
+    std::atomic<int> handledCount{ 0 };
+    auto handler = [&](const TestEvent&) {
+        while (!isOpen.load()) {
+            std::this_thread::yield();
+        }
+        ++handledCount;
+    };
+    bus.Add<TestEvent>(handler);
+
+    EXPECT_TRUE(bus.PollAsync());
+
+    bus.Post(TestEvent{ "Async Message" }, worm::DispatchType::ASYNC);
+    bus.Post(TestEvent{ "Detached Message" }, worm::DispatchType::ASYNC_DETACHED);
+    EXPECT_EQ(bus.GetPendingAsyncCount(), 2);
+    EXPECT_FALSE(bus.PollAsync());
+    EXPECT_FALSE(bus.WaitAsync(std::chrono::milliseconds{ 10 }));
+
+    isOpen = true;
+    EXPECT_TRUE(bus.WaitAsync(std::chrono::seconds{ 10 }));
+    EXPECT_EQ(handledCount.load(), 2);
+    EXPECT_EQ(bus.GetPendingAsyncCount(), 0);
+}
+
+#endif
@@ -6,6 +6,9 @@
 #include <worm/EventChannel.h>
 
 #include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 TEST(EventChannelTest, AddAndRemoveHandlers)
 {
@@ -71,6 +74,425 @@ TEST(EventChannelTest, PostAsyncEvents)
     worm::EventChannel::Remove<TestEvent>(handler);
 }
 
+TEST(EventChannelTest, PostDetachedEvents)
+{
+    MockHandler handler;
+    worm::EventChannel::Add<TestEvent>(handler);
+
+    // Post a detached asynchronous event
+    worm::EventChannel::Post(TestEvent{ "Detached Message" }, worm::DispatchType::ASYNC_DETACHED);
+
+    // Wait for all async events
+    worm::EventChannel::DispatchAllAsync();
+
+    // Verify the message is delivered
+    EXPECT_EQ(handler.GetMessages().size(), 1);
+    EXPECT_EQ(handler.GetMessages()[0], "Detached Message");
+
+    worm::EventChannel::Remove<TestEvent>(handler);
+}
+
+TEST(EventChannelTest, PostMovedEventsWithoutCopies)
+{
+    CopyCountingHandler handler;
+    worm::EventChannel::Add<CopyCountingEvent>(handler);
+
+    CopyCountingEvent::copyCount = 0;
+
+    // Post temporaries - they are moved to the queue storage
+    worm::EventChannel::Post(CopyCountingEvent{ "Sync Message" }, worm::DispatchType::SYNC);
+    worm::EventChannel::Post(CopyCountingEvent{ "Queued Message" }, worm::DispatchType::QUEUED);
+    worm::EventChannel::Post(CopyCountingEvent{ "Async Message" }, worm::DispatchType::ASYNC);
+    worm::EventChannel::Post(CopyCountingEvent{ "Detached Message" }, worm::DispatchType::ASYNC_DETACHED);
+
+    worm::EventChannel::DispatchAll();
+
+    EXPECT_EQ(handler.GetMessages().size(), 4);
+    EXPECT_EQ(CopyCountingEvent::copyCount, 0);
+
+    // Lvalues are still copied for the deferred dispatch types
+    CopyCountingEvent event{ "Queued Copy" };
+    worm::EventChannel::Post(event, worm::DispatchType::QUEUED);
+    worm::EventChannel::DispatchAllQueued();
+
+    EXPECT_EQ(handler.GetMessages().size(), 5);
+    EXPECT_EQ(CopyCountingEvent::copyCount, 1);
+
+    worm::EventChannel::Remove<CopyCountingEvent>(handler);
+}
+
+TEST(EventChannelTest, EmplaceEvents)
+{
+    CopyCountingHandler handler;
+    worm::EventChannel::Add<CopyCountingEvent>(handler);
+
+    CopyCountingEvent::copyCount = 0;
+
+    // Construct the events directly in the queue storage
+    worm::EventChannel::Emplace<CopyCountingEvent>(worm::DispatchType::SYNC, "Sync Message");
+    worm::EventChannel::Emplace<CopyCountingEvent>(worm::DispatchType::QUEUED, "Queued Message");
+    worm::EventChannel::Emplace<CopyCountingEvent>(worm::DispatchType::ASYNC, "Async Message");
+    worm::EventChannel::Emplace<CopyCountingEvent>(worm::DispatchType::ASYNC_DETACHED, "Detached Message");
+
+    worm::EventChannel::DispatchAll();
+
+    EXPECT_EQ(handler.GetMessages().size(), 4);
+    EXPECT_EQ(handler.GetMessages()[0], "Sync Message");
+    EXPECT_EQ(CopyCountingEvent::copyCount, 0);
+
+    // Aggregate events are brace-initialized
+    MockHandler testEventHandler;
+    worm::EventChannel::Add<TestEvent>(testEventHandler);
+
+    worm::EventChannel::Emplace<TestEvent>(worm::DispatchType::QUEUED, "Emplaced Message");
+    worm::EventChannel::DispatchAllQueued();
+
+    EXPECT_EQ(testEventHandler.GetMessages().size(), 1);
+    EXPECT_EQ(testEventHandler.GetMessages()[0], "Emplaced Message");
+
+    worm::EventChannel::Remove<TestEvent>(testEventHandler);
+    worm::EventChannel::Remove<CopyCountingEvent>(handler);
+}
+
+TEST(EventChannelTest, PostBatches)
+{
+    MockHandler handler;
+    worm::EventChannel::Add<TestEvent>(handler);
+
+    const std::vector<TestEvent> batch{ { "Message 1" }, { "Message 2" }, { "Message 3" } };
+
+    // Post the batch in all dispatch modes
+    worm::EventChannel::PostBatch<TestEvent>(batch.begin(), batch.end(), worm::DispatchType::SYNC);
+    EXPECT_EQ(handler.GetMessages().size(), 3);
+
+    worm::EventChannel::PostBatch<TestEvent>(batch.begin(), batch.end(), worm::DispatchType::QUEUED);
+    EXPECT_EQ(handler.GetMessages().size(), 3);
+    worm::EventChannel::DispatchAllQueued();
+    EXPECT_EQ(handler.GetMessages().size(), 6);
+
+    worm::EventChannel::PostBatch<TestEvent>(batch.begin(), batch.end(), worm::DispatchType::ASYNC);
+    worm::EventChannel::PostBatch<TestEvent>(batch.begin(), batch.end(), worm::DispatchType::ASYNC_DETACHED);
+    worm::EventChannel::DispatchAllAsync();
+
+    // Messages of a batch are delivered in order
+    const auto messages = handler.GetMessages();
+    ASSERT_EQ(messages.size(), 12);
+    for (size_t i = 0; i < messages.size(); ++i) {
+        EXPECT_EQ(messages[i], batch[i % batch.size()].message);
+    }
+
+    worm::EventChannel::Remove<TestEvent>(handler);
+}
+
+TEST(EventChannelTest, PostMovedBatchWithoutCopies)
+{
+    CopyCountingHandler handler;
+    worm::EventChannel::Add<CopyCountingEvent>(handler);
+
+    std::vector<CopyCountingEvent> batch{ CopyCountingEvent{ "Message 1" }, CopyCountingEvent{ "Message 2" } };
+
+    CopyCountingEvent::copyCount = 0;
+    worm::EventChannel::PostBatch<CopyCountingEvent>(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()), worm::DispatchType::ASYNC);
+    worm::EventChannel::DispatchAllAsync();
+
+    EXPECT_EQ(handler.GetMessages(), (std::vector<std::string>{ "Message 1", "Message 2" }));
+    EXPECT_EQ(CopyCountingEvent::copyCount, 0);
+
+    worm::EventChannel::Remove<CopyCountingEvent>(handler);
+}
+
+TEST(EventChannelTest, BoundedQueuedChannel)
+{
+    struct BoundedEvent {
+        std::string message;
+    };
+
+    struct BoundedHandler {
+        void operator()(const BoundedEvent& event)
+        {
+            messages.push_back(event.message);
+        }
+
+        std::vector<std::string> messages;
+    } handler;
+
+    auto token = worm::EventChannel::Add<BoundedEvent>(handler);
+
+    // The newest message is rejected once the capacity is reached
+    worm::EventChannel::SetQueuedCapacity<BoundedEvent>(2, worm::OverflowPolicy::FAIL);
+    EXPECT_TRUE(worm::EventChannel::Post(BoundedEvent{ "Message 1" }, worm::DispatchType::QUEUED));
+    EXPECT_TRUE(worm::EventChannel::Post(BoundedEvent{ "Message 2" }, worm::DispatchType::QUEUED));
+    EXPECT_FALSE(worm::EventChannel::Post(BoundedEvent{ "Message 3" }, worm::DispatchType::QUEUED));
+
+    // The capacity can not be changed while there are queued messages
+    EXPECT_THROW(worm::EventChannel::SetQueuedCapacity<BoundedEvent>(4), std::runtime_error);
+
+    worm::EventChannel::DispatchAllQueued();
+    EXPECT_EQ(handler.messages, (std::vector<std::string>{ "Message 1", "Message 2" }));
+
+    // The oldest message is replaced
+    worm::EventChannel::SetQueuedCapacity<BoundedEvent>(2, worm::OverflowPolicy::DROP_OLDEST);
+    const std::vector<BoundedEvent> batch{ { "Message 4" }, { "Message 5" }, { "Message 6" } };
+    EXPECT_EQ(worm::EventChannel::PostBatch<BoundedEvent>(batch.begin(), batch.end(), worm::DispatchType::QUEUED), 3);
+
+    handler.messages.clear();
+    worm::EventChannel::DispatchAllQueued();
+    EXPECT_EQ(handler.messages, (std::vector<std::string>{ "Message 5", "Message 6" }));
+
+    // The newest message is dropped and not reported as accepted
+    worm::EventChannel::SetQueuedCapacity<BoundedEvent>(2, worm::OverflowPolicy::DROP_NEWEST);
+    EXPECT_TRUE(worm::EventChannel::Post(BoundedEvent{ "Message 7" }, worm::DispatchType::QUEUED));
+    const std::vector<BoundedEvent> droppedBatch{ { "Message 8" }, { "Message 9" }, { "Message 10" } };
+    EXPECT_EQ(worm::EventChannel::PostBatch<BoundedEvent>(droppedBatch.begin(), droppedBatch.end(), worm::DispatchType::QUEUED), 1);
+    EXPECT_FALSE(worm::EventChannel::Post(BoundedEvent{ "Message 11" }, worm::DispatchType::QUEUED));
+
+    handler.messages.clear();
+    worm::EventChannel::DispatchAllQueued();
+    EXPECT_EQ(handler.messages, (std::vector<std::string>{ "Message 7", "Message 8" }));
+
+    // Dropped messages are counted
+    for (const auto& metrics : worm::EventChannel::GetMetrics()) {
+        if (metrics.eventTypeName.find("BoundedEvent") != std::string::npos) {
+            EXPECT_EQ(metrics.droppedCount, 4);
+            EXPECT_EQ(metrics.queuedCount, 0);
+        }
+    }
+
+    worm::EventChannel::SetQueuedCapacity<BoundedEvent>(0);
+    worm::EventChannel::Remove<BoundedEvent>(token);
+}
+
+TEST(EventChannelTest, CoalescedQueuedChannel)
+{
+    struct GaugeEvent {
+        size_t gauge;
+
+        int value;
+    };
+
+    struct GaugeHandler {
+        void operator()(const GaugeEvent& event)
+        {
+            values.emplace_back(event.gauge, event.value);
+        }
+
+        std::vector<std::pair<size_t, int>> values;
+    } handler;
+
+    auto token = worm::EventChannel::Add<GaugeEvent>(handler);
+    worm::EventChannel::SetQueuedCoalescing<GaugeEvent>([](const GaugeEvent& event) { return event.gauge; });
+
+    // A coalescing channel can not be bounded
+    EXPECT_THROW(worm::EventChannel::SetQueuedCapacity<GaugeEvent>(4), std::runtime_error);
+
+    // Only the latest value of every gauge is dispatched
+    for (int i = 0; i < 1000; ++i) {
+        worm::EventChannel::Emplace<GaugeEvent>(worm::DispatchType::QUEUED, static_cast<size_t>(i % 10), i);
+    }
+    const std::vector<GaugeEvent> batch{ { 0, 1000 }, { 10, 1001 } };
+    EXPECT_EQ(worm::EventChannel::PostBatch<GaugeEvent>(batch.begin(), batch.end(), worm::DispatchType::QUEUED), 2);
+
+    worm::EventChannel::DispatchAllQueued();
+    ASSERT_EQ(handler.values.size(), 11);
+    EXPECT_EQ(handler.values.front(), std::make_pair(size_t{ 0 }, 1000));
+    EXPECT_EQ(handler.values[9], std::make_pair(size_t{ 9 }, 999));
+    EXPECT_EQ(handler.values.back(), std::make_pair(size_t{ 10 }, 1001));
+
+    for (const auto& metrics : worm::EventChannel::GetMetrics()) {
+        if (metrics.eventTypeName.find("GaugeEvent") != std::string::npos) {
+            EXPECT_EQ(metrics.postedCount, 1002);
+            EXPECT_EQ(metrics.coalescedCount, 991);
+            EXPECT_EQ(metrics.queuedCount, 0);
+        }
+    }
+
+    worm::EventChannel::SetQueuedCoalescing<GaugeEvent>(nullptr);
+    worm::EventChannel::Remove<GaugeEvent>(token);
+}
+
+TEST(EventChannelTest, CycleArenaQueuedAllocation)
+{
+    struct ArenaEvent {
+        std::string message;
+    };
+
+    struct ArenaHandler {
+        void operator()(const ArenaEvent& event)
+        {
+            messages.push_back(event.message);
+        }
+
+        std::vector<std::string> messages;
+    } handler;
+
+    auto token = worm::EventChannel::Add<ArenaEvent>(handler);
+    worm::EventChannel::SetQueuedAllocation<ArenaEvent>(worm::QueuedAllocation::CYCLE_ARENA);
+
+    const auto resetCount = worm::EventChannel::GetCycleArenaStats().resetCount;
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        worm::EventChannel::Post(ArenaEvent{ "Message 1" }, worm::DispatchType::QUEUED);
+        worm::EventChannel::Emplace<ArenaEvent>(worm::DispatchType::QUEUED, "Message 2");
+        const std::vector<ArenaEvent> batch{ { "Message 3" }, { "Message 4" } };
+        worm::EventChannel::PostBatch<ArenaEvent>(batch.begin(), batch.end(), worm::DispatchType::QUEUED);
+
+        // The allocation can not be changed while there are queued messages
+        EXPECT_THROW(worm::EventChannel::SetQueuedAllocation<ArenaEvent>(worm::QueuedAllocation::HEAP), std::runtime_error);
+
+        worm::EventChannel::DispatchAllQueued();
+    }
+    EXPECT_EQ(handler.messages.size(), 12);
+    EXPECT_EQ(handler.messages.back(), "Message 4");
+
+    // The arena is rewound after every dispatched cycle
+    EXPECT_GE(worm::EventChannel::GetCycleArenaStats().resetCount, resetCount + 2);
+
+    worm::EventChannel::SetQueuedAllocation<ArenaEvent>(worm::QueuedAllocation::HEAP);
+    worm::EventChannel::Remove<ArenaEvent>(token);
+}
+
+TEST(EventChannelTest, ProducerBufferedQueuedChannel)
+{
+    struct StagedEvent {
+        size_t producer;
+
+        size_t sequence;
+    };
+
+    struct StagedHandler {
+        void operator()(const StagedEvent& event)
+        {
+            // The events of one producer keep their order
+            EXPECT_EQ(event.sequence, nextSequences[event.producer]++);
+        }
+
+        std::vector<size_t> nextSequences;
+    } handler{ std::vector<size_t>(4, 0) };
+
+    auto token = worm::EventChannel::Add<StagedEvent>(handler);
+    worm::EventChannel::SetQueuedProducerBuffering<StagedEvent>(true);
+
+    // Producer buffers can not be bounded
+    EXPECT_THROW(worm::EventChannel::SetQueuedCapacity<StagedEvent>(4), std::runtime_error);
+
+    std::vector<std::thread> producers;
+    for (size_t producer = 0; producer < handler.nextSequences.size(); ++producer) {
+        producers.emplace_back([producer]() {
+            for (size_t i = 0; i < 500; ++i) {
+                worm::EventChannel::Post(StagedEvent{ producer, i }, worm::DispatchType::QUEUED);
+            }
+            const std::vector<StagedEvent> batch{ { producer, 500 }, { producer, 501 } };
+            worm::EventChannel::PostBatch<StagedEvent>(batch.begin(), batch.end(), worm::DispatchType::QUEUED);
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    worm::EventChannel::DispatchAllQueued();
+    EXPECT_EQ(handler.nextSequences, std::vector<size_t>(4, 502));
+
+    worm::EventChannel::SetQueuedProducerBuffering<StagedEvent>(false);
+    worm::EventChannel::Remove<StagedEvent>(token);
+}
+
+TEST(EventChannelTest, QueuedPriorities)
+{
+    MockHandler handler;
+    auto token = worm::EventChannel::Add<TestEvent>(handler);
+
+    worm::EventChannel::Post(TestEvent{ "Normal Message 1" }, worm::DispatchType::QUEUED);
+    worm::EventChannel::Post(TestEvent{ "Low Message" }, worm::DispatchType::QUEUED, worm::Priority::LOW);
+    worm::EventChannel::Post(TestEvent{ "Normal Message 2" }, worm::DispatchType::QUEUED);
+    worm::EventChannel::Post(TestEvent{ "Critical Message" }, worm::DispatchType::QUEUED, worm::Priority::CRITICAL);
+
+    const std::vector<TestEvent> batch{ { "High Message 1" }, { "High Message 2" } };
+    worm::EventChannel::PostBatch<TestEvent>(batch.begin(), batch.end(), worm::DispatchType::QUEUED, worm::Priority::HIGH);
+
+    // Higher priorities are dispatched first, the events of one priority stay in order
+    worm::EventChannel::DispatchAllQueued();
+    EXPECT_EQ(handler.GetMessages(), (std::vector<std::string>{ "Critical Message", "High Message 1", "High Message 2", "Normal Message 1", "Normal Message 2", "Low Message" }));
+
+    worm::EventChannel::Remove<TestEvent>(token);
+}
+
+TEST(EventChannelTest, RoutedHandlers)
+{
+    struct EntityChangedEvent {
+        size_t entityId;
+    };
+
+    struct EntityHandler {
+        void operator()(const EntityChangedEvent& event)
+        {
+            entityIds.push_back(event.entityId);
+        }
+
+        std::vector<size_t> entityIds;
+    };
+
+    std::vector<EntityHandler> entities(100);
+    EntityHandler wildcard;
+
+    // A routed handler can not be added without the routing key function
+    EXPECT_THROW(worm::EventChannel::Add<EntityChangedEvent>(entities[0], 0), std::runtime_error);
+
+    worm::EventChannel::SetRoutingKeyFunction<EntityChangedEvent>([](const EntityChangedEvent& event) { return event.entityId; });
+
+    std::vector<worm::SubscriptionToken> tokens;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        tokens.push_back(worm::EventChannel::Add<EntityChangedEvent>(entities[i], i));
+    }
+    tokens.push_back(worm::EventChannel::Add<EntityChangedEvent>(wildcard));
+
+    // The routing can not be turned off while there are routed handlers
+    EXPECT_THROW(worm::EventChannel::SetRoutingKeyFunction<EntityChangedEvent>(nullptr), std::runtime_error);
+
+    // Only the matching and the wildcard handlers are called
+    worm::EventChannel::Post(EntityChangedEvent{ 42 });
+    worm::EventChannel::Post(EntityChangedEvent{ 7 }, worm::DispatchType::QUEUED);
+    worm::EventChannel::Post(EntityChangedEvent{ 1000 });
+    worm::EventChannel::DispatchAllQueued();
+
+    for (size_t i = 0; i < entities.size(); ++i) {
+        EXPECT_EQ(entities[i].entityIds, i == 42 || i == 7 ? std::vector<size_t>{ i } : std::vector<size_t>{});
+    }
+    EXPECT_EQ(wildcard.entityIds, (std::vector<size_t>{ 42, 1000, 7 }));
+
+    // A removed routed handler is not called anymore
+    worm::EventChannel::Remove<EntityChangedEvent>(tokens[42]);
+    worm::EventChannel::Post(EntityChangedEvent{ 42 });
+    EXPECT_EQ(entities[42].entityIds.size(), 1);
+
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (i != 42) {
+            worm::EventChannel::Remove<EntityChangedEvent>(tokens[i]);
+        }
+    }
+    worm::EventChannel::SetRoutingKeyFunction<EntityChangedEvent>(nullptr);
+}
+
+TEST(EventChannelTest, RemoveHandlersByToken)
+{
+    MockHandler handler1, handler2;
+    auto token1 = worm::EventChannel::Add<TestEvent>(handler1);
+    auto token2 = worm::EventChannel::Add<TestEvent>(handler2);
+
+    worm::EventChannel::Post(TestEvent{ "Test Message" }, worm::DispatchType::SYNC);
+
+    // Remove the handler by its token
+    worm::EventChannel::Remove<TestEvent>(token1);
+
+    worm::EventChannel::Post(TestEvent{ "Another Message" }, worm::DispatchType::SYNC);
+
+    EXPECT_EQ(handler1.GetMessages().size(), 1);
+    EXPECT_EQ(handler2.GetMessages().size(), 2);
+
+    // A token can be used only once
+    EXPECT_THROW(worm::EventChannel::Remove<TestEvent>(token1), std::runtime_error);
+
+    worm::EventChannel::Remove<TestEvent>(token2);
+}
+
 TEST(EventChannelTest, RemoveNonexistentHandlerThrows)
 {
     MockHandler handler;
@@ -0,0 +1,101 @@
+#ifndef __WORM_EVENT_RECORDER_TESTS_H__
+#define __WORM_EVENT_RECORDER_TESTS_H__
+
+#include "Common.h"
+
+#include <worm/EventRecorder.h>
+
+#if WH_HAS_MAPPED_FILES
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct RecordedPosition {
+    int id;
+
+    float x;
+
+    float y;
+};
+
+struct RecordedClick {
+    int button;
+};
+
+TEST(EventRecorderTest, RecordAndReplay)
+{
+    const auto path{ (std::filesystem::temp_directory_path() / ("wh_event_recorder_test_" + std::to_string(::getpid()) + ".bin")).string() };
+    {
+        worm::EventBus bus{ 1 };
+        worm::EventRecorder recorder{ bus, path };
+        recorder.Record<RecordedPosition>(1);
+        recorder.Record<RecordedClick>(2);
+
+        // A type can be recorded by one recorder only
+        EXPECT_THROW(recorder.Record<RecordedClick>(3), std::runtime_error);
+
+        bus.Post(RecordedPosition{ 1, 1.0f, 2.0f });
+        bus.Post(RecordedClick{ 3 });
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        bus.Post(RecordedPosition{ 2, 3.0f, 4.0f }, worm::DispatchType::QUEUED, worm::Priority::HIGH);
+
+        // Messages are recorded when posted, also the dropped ones
+        bus.SetQueuedCapacity<RecordedClick>(1, worm::OverflowPolicy::DROP_NEWEST);
+        bus.Post(RecordedClick{ 4 }, worm::DispatchType::QUEUED);
+        EXPECT_FALSE(bus.Post(RecordedClick{ 5 }, worm::DispatchType::QUEUED));
+        EXPECT_EQ(recorder.GetRecordCount(), 5);
+
+        bus.DispatchAllQueued();
+        bus.SetQueuedCapacity<RecordedClick>(0);
+
+        EXPECT_EQ(recorder.GetRecordCount(), 5);
+        EXPECT_EQ(recorder.GetDroppedCount(), 0);
+    }
+
+    struct PositionHandler {
+        void operator()(const RecordedPosition& position)
+        {
+            positions.push_back(position);
+        }
+
+        std::vector<RecordedPosition> positions;
+    } handler;
+
+    worm::EventBus bus{ 1 };
+    auto token = bus.Add<RecordedPosition>(handler);
+
+    // Only the registered types are replayed, with the recorded dispatch types
+    worm::EventReplayer replayer{ bus, path };
+    replayer.Register<RecordedPosition>(1);
+    EXPECT_EQ(replayer.Replay(), 2);
+    ASSERT_EQ(handler.positions.size(), 1);
+    EXPECT_EQ(handler.positions[0].id, 1);
+
+    bus.DispatchAllQueued();
+    ASSERT_EQ(handler.positions.size(), 2);
+    EXPECT_EQ(handler.positions[1].id, 2);
+    EXPECT_EQ(handler.positions[1].y, 4.0f);
+
+    // The original timing keeps the recorded gaps, the dispatch type can be overridden
+    replayer.Register<RecordedPosition>(1, worm::DispatchType::SYNC);
+    const auto start{ std::chrono::steady_clock::now() };
+    EXPECT_EQ(replayer.Replay(worm::ReplayTiming::ORIGINAL), 2);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20));
+    EXPECT_EQ(handler.positions.size(), 4);
+
+    // A type of a different size can not be replayed from the records
+    replayer.Register<RecordedClick>(1);
+    EXPECT_THROW(replayer.Replay(), std::runtime_error);
+
+    bus.Remove<RecordedPosition>(token);
+    std::remove(path.c_str());
+}
+
+#endif
+
+#endif
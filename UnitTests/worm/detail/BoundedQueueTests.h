@@ -0,0 +1,155 @@
+#ifndef __WORM_DETAIL_BOUNDED_QUEUE_TESTS_H__
+#define __WORM_DETAIL_BOUNDED_QUEUE_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/BoundedQueue.h>
+
+#include <atomic>
+#include <thread>
+
+using worm::detail::BoundedQueue;
+using worm::detail::OverflowPolicy;
+using worm::detail::PushResult;
+
+TEST(BoundedQueueTest, DropNewest)
+{
+    BoundedQueue<int> queue(2, OverflowPolicy::DROP_NEWEST);
+
+    EXPECT_EQ(queue.Emplace(1), PushResult::PUSHED);
+    EXPECT_EQ(queue.Emplace(2), PushResult::PUSHED);
+    EXPECT_EQ(queue.Emplace(3), PushResult::DROPPED_NEWEST);
+
+    std::vector<int> items;
+    EXPECT_EQ(queue.ConsumeAll([&](int item) { items.push_back(item); }), 2);
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2 }));
+}
+
+TEST(BoundedQueueTest, DropOldest)
+{
+    BoundedQueue<int> queue(2, OverflowPolicy::DROP_OLDEST);
+
+    EXPECT_EQ(queue.Emplace(1), PushResult::PUSHED);
+    EXPECT_EQ(queue.Emplace(2), PushResult::PUSHED);
+    EXPECT_EQ(queue.Emplace(3), PushResult::DROPPED_OLDEST);
+
+    std::vector<int> items;
+    EXPECT_EQ(queue.ConsumeAll([&](int item) { items.push_back(item); }), 2);
+    EXPECT_EQ(items, (std::vector<int>{ 2, 3 }));
+}
+
+TEST(BoundedQueueTest, Fail)
+{
+    BoundedQueue<std::string> queue(1, OverflowPolicy::FAIL);
+
+    EXPECT_EQ(queue.Emplace("Message 1"), PushResult::PUSHED);
+    EXPECT_EQ(queue.Emplace("Message 2"), PushResult::REJECTED);
+
+    // There is space again once consumed
+    queue.ConsumeAll([](const std::string&) {});
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_EQ(queue.Emplace("Message 3"), PushResult::PUSHED);
+}
+
+TEST(BoundedQueueTest, BlockUntilConsumed)
+{
+    BoundedQueue<int> queue(1, OverflowPolicy::BLOCK);
+
+    EXPECT_EQ(queue.Emplace(1), PushResult::PUSHED);
+
+    std::atomic<bool> pushed{ false };
+    std::thread producer([&]() {
+        EXPECT_EQ(queue.Emplace(2), PushResult::PUSHED);
+        pushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(pushed);
+
+    std::vector<int> items;
+    while (items.size() < 2) {
+        queue.ConsumeAll([&](int item) { items.push_back(item); });
+    }
+    producer.join();
+
+    EXPECT_TRUE(pushed);
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2 }));
+}
+
+TEST(BoundedQueueTest, PushWhileConsuming)
+{
+    BoundedQueue<int> queue(2, OverflowPolicy::FAIL);
+
+    queue.Emplace(1);
+    queue.Emplace(2);
+
+    // The pending items are swapped out, so the whole capacity is available while consuming
+    std::vector<int> items;
+    EXPECT_EQ(queue.ConsumeAll([&](int item) {
+        items.push_back(item);
+        if (item == 1) {
+            EXPECT_EQ(queue.Emplace(3), PushResult::PUSHED);
+            EXPECT_EQ(queue.Emplace(4), PushResult::PUSHED);
+            EXPECT_EQ(queue.Emplace(5), PushResult::REJECTED);
+        }
+    }),
+        2);
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2 }));
+
+    // Items pushed while consuming are left for the next call
+    items.clear();
+    EXPECT_EQ(queue.ConsumeAll([&](int item) { items.push_back(item); }), 2);
+    EXPECT_EQ(items, (std::vector<int>{ 3, 4 }));
+}
+
+TEST(BoundedQueueTest, ConsumerExceptionKeepsRemainingItems)
+{
+    BoundedQueue<int> queue(4, OverflowPolicy::FAIL);
+
+    queue.Emplace(1);
+    queue.Emplace(2);
+    queue.Emplace(3);
+
+    std::vector<int> items;
+    EXPECT_THROW(queue.ConsumeAll([&](int item) {
+        items.push_back(item);
+        if (item == 2) {
+            throw std::runtime_error("Consumer failure");
+        }
+    }),
+        std::runtime_error);
+
+    queue.Emplace(4);
+
+    // The failed item is not delivered again, the rest comes first
+    EXPECT_EQ(queue.ConsumeAll([&](int item) { items.push_back(item); }), 2);
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2, 3, 4 }));
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(BoundedQueueTest, ZeroCapacityThrows)
+{
+    EXPECT_THROW(BoundedQueue<int>(0, OverflowPolicy::BLOCK), std::runtime_error);
+}
+
+TEST(BoundedQueueTest, ConsumeLimitedLeavesRoomForProducers)
+{
+    BoundedQueue<int> queue(2, OverflowPolicy::FAIL);
+
+    EXPECT_EQ(queue.Emplace(1), PushResult::PUSHED);
+    EXPECT_EQ(queue.Emplace(2), PushResult::PUSHED);
+
+    std::vector<int> items;
+    EXPECT_EQ(queue.Consume(1, [&](int item) { items.push_back(item); }), 1);
+
+    // The item left behind is not counted against the capacity
+    EXPECT_EQ(queue.Emplace(3), PushResult::PUSHED);
+    EXPECT_EQ(queue.Emplace(4), PushResult::PUSHED);
+    EXPECT_EQ(queue.Emplace(5), PushResult::REJECTED);
+
+    EXPECT_EQ(queue.Consume(10, [&](int item) { items.push_back(item); }), 3);
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2, 3, 4 }));
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+#endif
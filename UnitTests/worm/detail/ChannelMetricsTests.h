@@ -0,0 +1,107 @@
+#ifndef __WORM_DETAIL_CHANNEL_METRICS_TESTS_H__
+#define __WORM_DETAIL_CHANNEL_METRICS_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/ChannelMetrics.h>
+
+#include <thread>
+
+TEST(ChannelMetricsTest, CollectCounters)
+{
+    worm::detail::ChannelMetrics metrics;
+
+    metrics.OnPosted(3);
+    metrics.OnQueued(0, 2);
+    metrics.OnQueued(3);
+    metrics.OnDequeued(0);
+    metrics.OnAsyncScheduled(2);
+    metrics.OnAsyncCompleted();
+    metrics.OnDropped();
+
+    worm::detail::ChannelMetricsSnapshot snapshot;
+    metrics.Collect(snapshot);
+
+    EXPECT_EQ(snapshot.postedCount, 3);
+    EXPECT_EQ(snapshot.queuedCount, 2);
+    EXPECT_EQ(metrics.GetQueuedCount(0), 1);
+    EXPECT_EQ(metrics.GetQueuedCount(3), 1);
+    EXPECT_EQ(snapshot.asyncInFlightCount, 1);
+    EXPECT_EQ(snapshot.droppedCount, 1);
+    EXPECT_EQ(snapshot.dispatchedCount, 0);
+}
+
+TEST(ChannelMetricsTest, LatencyHistogram)
+{
+    worm::detail::ChannelMetrics metrics;
+
+    metrics.OnLatencySampled(0);
+    metrics.OnLatencySampled(1);
+    metrics.OnLatencySampled(1000);
+    metrics.OnLatencySampled(1023);
+    metrics.OnLatencySampled(1024);
+    metrics.OnLatencySampled(std::numeric_limits<int64_t>::max());
+
+    worm::detail::ChannelMetricsSnapshot snapshot;
+    metrics.Collect(snapshot);
+
+    EXPECT_EQ(snapshot.dispatchLatencyHistogram[0], 1);
+    EXPECT_EQ(snapshot.dispatchLatencyHistogram[1], 1);
+    EXPECT_EQ(snapshot.dispatchLatencyHistogram[10], 2);
+    EXPECT_EQ(snapshot.dispatchLatencyHistogram[11], 1);
+    EXPECT_EQ(snapshot.dispatchLatencyHistogram[worm::detail::ChannelMetricsSnapshot::LATENCY_BUCKET_COUNT - 1], 1);
+}
+
+TEST(ChannelMetricsTest, LatencyIsSampled)
+{
+    worm::detail::ChannelMetrics metrics;
+
+    // Every dispatch is counted, only every LATENCY_SAMPLE_INTERVAL-th of the thread is timed
+    const auto dispatchCount = worm::detail::ChannelMetrics::LATENCY_SAMPLE_INTERVAL * 3;
+    for (uint64_t i = 0; i < dispatchCount; ++i) {
+        worm::detail::ChannelMetrics::DispatchScope scope{ metrics };
+    }
+
+    worm::detail::ChannelMetricsSnapshot snapshot;
+    metrics.Collect(snapshot);
+
+    uint64_t sampledCount = 0;
+    for (const auto count : snapshot.dispatchLatencyHistogram) {
+        sampledCount += count;
+    }
+    EXPECT_EQ(snapshot.dispatchedCount, dispatchCount);
+    EXPECT_EQ(sampledCount, 3);
+}
+
+TEST(ChannelMetricsTest, CountersFromMultipleThreads)
+{
+    worm::detail::ChannelMetrics metrics;
+
+    const int threadCount = 8;
+    const int postCount = 10000;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < postCount; ++j) {
+                metrics.OnPosted();
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    worm::detail::ChannelMetricsSnapshot snapshot;
+    metrics.Collect(snapshot);
+
+    EXPECT_EQ(snapshot.postedCount, threadCount * postCount);
+}
+
+TEST(ChannelMetricsTest, TypeName)
+{
+    EXPECT_NE(worm::detail::GetTypeName<TestEvent>().find("TestEvent"), std::string::npos);
+}
+
+#endif
@@ -0,0 +1,101 @@
+#ifndef __WORM_DETAIL_COALESCING_QUEUE_TESTS_H__
+#define __WORM_DETAIL_COALESCING_QUEUE_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/CoalescingQueue.h>
+
+#include <stdexcept>
+#include <utility>
+
+using worm::detail::CoalescingQueue;
+
+TEST(CoalescingQueueTest, LatestValueWins)
+{
+    CoalescingQueue<std::pair<size_t, int>> queue;
+
+    // 100 updates of 10 keys
+    for (int i = 0; i < 100; ++i) {
+        const auto key{ static_cast<size_t>(i % 10) };
+        EXPECT_EQ(queue.Emplace(key, key, i), i >= 10);
+    }
+
+    // The keys keep the order of their first update
+    std::vector<std::pair<size_t, int>> items;
+    EXPECT_EQ(queue.ConsumeAll([&](const std::pair<size_t, int>& item) { items.push_back(item); }), 10);
+    for (size_t i = 0; i < items.size(); ++i) {
+        EXPECT_EQ(items[i], std::make_pair(i, static_cast<int>(90 + i)));
+    }
+    EXPECT_TRUE(queue.IsEmpty());
+
+    // A consumed key is pending again
+    EXPECT_FALSE(queue.Emplace(0, 0, 100));
+}
+
+TEST(CoalescingQueueTest, KeysChangeBetweenCycles)
+{
+    CoalescingQueue<std::pair<size_t, int>> queue;
+
+    // The index nodes of a cycle are reused for other keys in the next one
+    for (size_t cycle = 0; cycle < 3; ++cycle) {
+        const auto keyCount{ 4 + cycle };
+        for (size_t i = 0; i < keyCount * 2; ++i) {
+            const auto key{ cycle * 10 + i % keyCount };
+            EXPECT_EQ(queue.Emplace(key, key, static_cast<int>(i)), i >= keyCount);
+        }
+
+        std::vector<std::pair<size_t, int>> items;
+        EXPECT_EQ(queue.ConsumeAll([&](const std::pair<size_t, int>& item) { items.push_back(item); }), keyCount);
+        for (size_t i = 0; i < items.size(); ++i) {
+            EXPECT_EQ(items[i], std::make_pair(cycle * 10 + i, static_cast<int>(keyCount + i)));
+        }
+    }
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(CoalescingQueueTest, ConsumerExceptionKeepsRemainingItems)
+{
+    CoalescingQueue<int> queue;
+    queue.Emplace(1, 1);
+    queue.Emplace(2, 2);
+    queue.Emplace(3, 3);
+
+    std::vector<int> items;
+    const auto consumer{ [&](int item) {
+        if (item == 2 && items.size() == 1) {
+            items.push_back(-1);
+            throw std::runtime_error("Consumer failed");
+        }
+        items.push_back(item);
+    } };
+
+    EXPECT_THROW(queue.ConsumeAll(consumer), std::runtime_error);
+
+    // The failed item is not consumed again, the rest is consumed before the new items
+    queue.Emplace(4, 4);
+    EXPECT_EQ(queue.ConsumeAll(consumer), 2);
+    EXPECT_EQ(items, (std::vector<int>{ 1, -1, 3, 4 }));
+}
+
+TEST(CoalescingQueueTest, ConsumeLimited)
+{
+    CoalescingQueue<std::pair<size_t, int>> queue;
+
+    for (int i = 0; i < 4; ++i) {
+        queue.Emplace(i, i, i);
+    }
+
+    std::vector<std::pair<size_t, int>> items;
+    const auto consumer{ [&](const std::pair<size_t, int>& item) { items.push_back(item); } };
+    EXPECT_EQ(queue.Consume(2, consumer), 2);
+
+    // The items left behind are no longer replaced
+    EXPECT_FALSE(queue.Emplace(3, 3, 4));
+    EXPECT_EQ(queue.Consume(10, consumer), 3);
+
+    const std::vector<std::pair<size_t, int>> expected{ { 0, 0 }, { 1, 1 }, { 2, 2 }, { 3, 3 }, { 3, 4 } };
+    EXPECT_EQ(items, expected);
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+#endif
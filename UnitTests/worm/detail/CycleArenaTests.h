@@ -0,0 +1,67 @@
+#ifndef __WORM_DETAIL_CYCLE_ARENA_TESTS_H__
+#define __WORM_DETAIL_CYCLE_ARENA_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/CycleArena.h>
+
+#include <cstdint>
+#include <thread>
+
+using worm::detail::CycleArena;
+
+TEST(CycleArenaTest, RewindOnceReleased)
+{
+    std::thread([]() {
+        const auto resetCount = CycleArena::GetStats().resetCount;
+
+        // The memory of a released cycle is reused by the next one
+        void* first = CycleArena::Allocate(100);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % CycleArena::ALIGNMENT, 0);
+        void* second = CycleArena::Allocate(100);
+        EXPECT_NE(first, second);
+
+        CycleArena::Deallocate(first);
+        CycleArena::Deallocate(second);
+
+        EXPECT_EQ(CycleArena::Allocate(100), first);
+        EXPECT_EQ(CycleArena::GetStats().resetCount, resetCount + 1);
+        CycleArena::Deallocate(first);
+
+        // No rewind while a block is still in use
+        void* kept = CycleArena::Allocate(100);
+        void* next = CycleArena::Allocate(100);
+        CycleArena::Deallocate(next);
+        next = CycleArena::Allocate(100);
+        EXPECT_NE(next, kept);
+        CycleArena::Deallocate(next);
+        CycleArena::Deallocate(kept);
+    }).join();
+}
+
+TEST(CycleArenaTest, ReleasedByAnotherThread)
+{
+    std::vector<void*> blocks;
+    std::thread([&blocks]() {
+        // More than a region
+        for (size_t i = 0; i < 2 * CycleArena::REGION_SIZE / 1024; ++i) {
+            blocks.push_back(CycleArena::Allocate(1000));
+        }
+
+        // Too big for a region
+        blocks.push_back(CycleArena::Allocate(2 * CycleArena::REGION_SIZE));
+    }).join();
+
+    // The regions stay valid after the thread exits until their last block is released
+    for (const auto block : blocks) {
+        static_cast<char*>(block)[0] = 1;
+        CycleArena::Deallocate(block);
+    }
+
+    const auto stats = CycleArena::GetStats();
+    EXPECT_GE(stats.blockAllocationCount, 3);
+    EXPECT_GE(stats.heapFallbackCount, 1);
+    EXPECT_GE(stats.allocationCount, blocks.size());
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef __WORM_DETAIL_DELEGATE_TESTS_H__
+#define __WORM_DETAIL_DELEGATE_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/Delegate.h>
+
+TEST(DelegateTest, InvokeHandler)
+{
+    MockHandler handler;
+
+    auto delegate = worm::detail::Delegate<TestEvent>::Create(handler);
+    EXPECT_TRUE(static_cast<bool>(delegate));
+
+    delegate(TestEvent{ "Test Message" });
+
+    EXPECT_EQ(handler.GetMessages().size(), 1);
+    EXPECT_EQ(handler.GetMessages()[0], "Test Message");
+}
+
+TEST(DelegateTest, Identity)
+{
+    MockHandler handler1, handler2;
+
+    auto delegate1 = worm::detail::Delegate<TestEvent>::Create(handler1);
+    auto delegate2 = worm::detail::Delegate<TestEvent>::Create(handler2);
+
+    // Delegates of the same handler instance are equal
+    EXPECT_EQ(delegate1, worm::detail::Delegate<TestEvent>::Create(handler1));
+    EXPECT_NE(delegate1, delegate2);
+
+    worm::detail::Delegate<TestEvent> empty;
+    EXPECT_FALSE(static_cast<bool>(empty));
+    EXPECT_NE(empty, delegate1);
+}
+
+TEST(DelegateTest, IsCompact)
+{
+    EXPECT_EQ(sizeof(worm::detail::Delegate<TestEvent>), 2 * sizeof(void*));
+}
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef __WORM_DETAIL_EPOCH_DOMAIN_TESTS_H__
+#define __WORM_DETAIL_EPOCH_DOMAIN_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/EpochDomain.h>
+
+#include <atomic>
+#include <thread>
+
+struct RetiredCounter {
+    static inline std::atomic<uint32_t> deletedCount{ 0 };
+
+    ~RetiredCounter()
+    {
+        ++deletedCount;
+    }
+};
+
+TEST(EpochDomainTest, RetiredObjectIsDeletedWithoutReaders)
+{
+    auto& domain = worm::detail::EpochDomain::Instance();
+
+    const auto deletedCount{ RetiredCounter::deletedCount.load() };
+
+    domain.Retire(new RetiredCounter{});
+
+    EXPECT_EQ(RetiredCounter::deletedCount, deletedCount + 1);
+}
+
+TEST(EpochDomainTest, ReaderDelaysReclamation)
+{
+    auto& domain = worm::detail::EpochDomain::Instance();
+
+    const auto deletedCount{ RetiredCounter::deletedCount.load() };
+
+    std::atomic<bool> reading{ false };
+    std::atomic<bool> done{ false };
+
+    std::thread reader([&]() {
+        worm::detail::EpochDomain::ReadGuard guard{ domain };
+        reading = true;
+        while (!done) {
+            std::this_thread::yield();
+        }
+    });
+
+    while (!reading) {
+        std::this_thread::yield();
+    }
+
+    // The reader started before the object was retired, so it might still reference it
+    domain.Retire(new RetiredCounter{});
+    EXPECT_EQ(RetiredCounter::deletedCount, deletedCount);
+
+    done = true;
+    reader.join();
+
+    domain.Reclaim();
+    EXPECT_EQ(RetiredCounter::deletedCount, deletedCount + 1);
+}
+
+TEST(EpochDomainTest, InactiveHandlerIsNotInvoked)
+{
+    auto& domain = worm::detail::EpochDomain::Instance();
+
+    std::atomic<bool> active{ false };
+    bool invoked{ false };
+
+    worm::detail::EpochDomain::ReadGuard guard{ domain };
+    guard.Invoke(&active, [&]() { return active.load(); }, [&]() { invoked = true; });
+    EXPECT_FALSE(invoked);
+
+    active = true;
+    guard.Invoke(&active, [&]() { return active.load(); }, [&]() { invoked = true; });
+    EXPECT_TRUE(invoked);
+}
+
+TEST(EpochDomainTest, WaitForInvocations)
+{
+    auto& domain = worm::detail::EpochDomain::Instance();
+
+    std::atomic<bool> active{ true };
+    std::atomic<bool> invoking{ false };
+    std::atomic<bool> finished{ false };
+
+    std::thread reader([&]() {
+        worm::detail::EpochDomain::ReadGuard guard{ domain };
+        guard.Invoke(&active, [&]() { return active.load(); }, [&]() {
+            invoking = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            finished = true;
+        });
+    });
+
+    while (!invoking) {
+        std::this_thread::yield();
+    }
+
+    // Blocks until the running invocation is done
+    active = false;
+    domain.WaitForInvocations(&active);
+    EXPECT_TRUE(finished);
+
+    reader.join();
+
+    // Invocations on the calling thread are not waited for
+    worm::detail::EpochDomain::ReadGuard guard{ domain };
+    active = true;
+    guard.Invoke(&active, [&]() { return active.load(); }, [&]() { domain.WaitForInvocations(&active); });
+}
+
+#endif
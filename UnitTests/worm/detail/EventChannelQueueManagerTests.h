@@ -6,6 +6,9 @@
 #include <worm/detail/EventChannelQueue.h>
 #include <worm/detail/EventChannelQueueManager.h>
 
+#include <atomic>
+#include <thread>
+
 TEST(EventChannelQueueManagerTest, DispatchAllQueuedEvents)
 {
     auto& queue = worm::detail::EventChannelQueue<TestEvent>::Instance();
@@ -73,4 +76,197 @@ TEST(EventChannelQueueManagerTest, DispatchAllWithMultipleQueues)
     queue2.Remove(handler2);
 }
 
+TEST(EventChannelQueueManagerTest, DispatchHigherPrioritiesOfAllQueuesFirst)
+{
+    struct BulkEvent {
+        std::string message;
+    };
+
+    struct ControlEvent {
+        std::string message;
+    };
+
+    struct OrderHandler {
+        void operator()(const BulkEvent& event)
+        {
+            messages.push_back(event.message);
+        }
+
+        void operator()(const ControlEvent& event)
+        {
+            messages.push_back(event.message);
+        }
+
+        std::vector<std::string> messages;
+    } handler;
+
+    auto& bulkQueue = worm::detail::EventChannelQueue<BulkEvent>::Instance();
+    auto& controlQueue = worm::detail::EventChannelQueue<ControlEvent>::Instance();
+    auto& manager = worm::detail::EventChannelQueueManager::Instance();
+
+    bulkQueue.Add(handler);
+    controlQueue.Add(handler);
+
+    bulkQueue.PostQueued(BulkEvent{ "Bulk Message" }, worm::detail::Priority::LOW);
+    controlQueue.PostQueued(ControlEvent{ "Control Message" });
+    bulkQueue.PostQueued(BulkEvent{ "Urgent Bulk Message" }, worm::detail::Priority::HIGH);
+
+    // The priorities are ordered across the channels
+    manager.DispatchAllQueued();
+    EXPECT_EQ(handler.messages, (std::vector<std::string>{ "Urgent Bulk Message", "Control Message", "Bulk Message" }));
+
+    bulkQueue.Remove(handler);
+    controlQueue.Remove(handler);
+}
+
+TEST(EventChannelQueueManagerTest, CollectMetrics)
+{
+    struct MetricsEvent {
+        int value;
+    };
+
+    struct MetricsHandler {
+        void operator()(const MetricsEvent&)
+        {
+        }
+    } handler;
+
+    auto& queue = worm::detail::EventChannelQueue<MetricsEvent>::Instance();
+    auto& manager = worm::detail::EventChannelQueueManager::Instance();
+
+    auto token = queue.Add(handler);
+
+    queue.Post(MetricsEvent{ 1 });
+    queue.PostQueued(MetricsEvent{ 2 });
+    queue.PostQueued(MetricsEvent{ 3 });
+    queue.PostAsync(MetricsEvent{ 4 });
+    queue.DispatchAllAsync();
+
+    auto findMetrics = [&]() {
+        for (const auto& metrics : manager.GetMetrics()) {
+            if (metrics.eventTypeName.find("MetricsEvent") != std::string::npos) {
+                return metrics;
+            }
+        }
+        return worm::detail::ChannelMetricsSnapshot{};
+    };
+
+    // Queued events are counted as posted but not dispatched yet
+    auto metrics = findMetrics();
+    EXPECT_EQ(metrics.postedCount, 4);
+    EXPECT_EQ(metrics.dispatchedCount, 2);
+    EXPECT_EQ(metrics.queuedCount, 2);
+    EXPECT_EQ(metrics.asyncInFlightCount, 0);
+
+    queue.DispatchAllQueued();
+
+    metrics = findMetrics();
+    EXPECT_EQ(metrics.dispatchedCount, 4);
+    EXPECT_EQ(metrics.queuedCount, 0);
+
+    // The first dispatch of a thread is always sampled, the SYNC and QUEUED ones ran on this thread
+    uint64_t histogramCount = 0;
+    for (const auto count : metrics.dispatchLatencyHistogram) {
+        histogramCount += count;
+    }
+    EXPECT_GE(histogramCount, 1);
+    EXPECT_LE(histogramCount, 2);
+
+    queue.Remove(token);
+}
+
+TEST(EventChannelQueueManagerTest, ParallelDispatchAllQueued)
+{
+    struct ParallelEvent1 {
+        int value;
+    };
+
+    struct ParallelEvent2 {
+        int value;
+    };
+
+    struct PinnedEvent {
+        int value;
+    };
+
+    struct ThreadRecordingHandler {
+        void operator()(const ParallelEvent1& event)
+        {
+            sum += event.value;
+        }
+
+        void operator()(const ParallelEvent2& event)
+        {
+            sum += event.value;
+        }
+
+        void operator()(const PinnedEvent& event)
+        {
+            sum += event.value;
+            pinnedThreadId = std::this_thread::get_id();
+        }
+
+        std::atomic<int> sum{ 0 };
+        std::thread::id pinnedThreadId;
+    } handler;
+
+    auto& manager = worm::detail::EventChannelQueueManager::Instance();
+    auto& queue1 = worm::detail::EventChannelQueue<ParallelEvent1>::Instance();
+    auto& queue2 = worm::detail::EventChannelQueue<ParallelEvent2>::Instance();
+    auto& pinnedQueue = worm::detail::EventChannelQueue<PinnedEvent>::Instance();
+
+    auto token1 = queue1.Add(handler);
+    auto token2 = queue2.Add(handler);
+    auto pinnedToken = pinnedQueue.Add(handler);
+
+    manager.SetParallelQueuedDispatch(true);
+    pinnedQueue.SetQueuedDispatchOnCallerThread(true);
+
+    for (int i = 1; i <= 100; ++i) {
+        queue1.PostQueued(ParallelEvent1{ i });
+        queue2.PostQueued(ParallelEvent2{ i });
+        pinnedQueue.PostQueued(PinnedEvent{ i });
+    }
+
+    // All the channels are drained before returning, the pinned one on the calling thread
+    manager.DispatchAllQueued();
+
+    EXPECT_EQ(handler.sum, 3 * 5050);
+    EXPECT_EQ(handler.pinnedThreadId, std::this_thread::get_id());
+
+    manager.SetParallelQueuedDispatch(false);
+    pinnedQueue.SetQueuedDispatchOnCallerThread(false);
+
+    queue1.Remove(token1);
+    queue2.Remove(token2);
+    pinnedQueue.Remove(pinnedToken);
+}
+
+TEST(EventChannelQueueManagerTest, ParallelDispatchAllQueuedRethrows)
+{
+    struct FailingEvent {
+    };
+
+    struct FailingHandler {
+        void operator()(const FailingEvent&)
+        {
+            throw std::runtime_error("Handler failure");
+        }
+    } handler;
+
+    auto& manager = worm::detail::EventChannelQueueManager::Instance();
+    auto& queue = worm::detail::EventChannelQueue<FailingEvent>::Instance();
+
+    auto token = queue.Add(handler);
+
+    manager.SetParallelQueuedDispatch(true);
+
+    queue.PostQueued(FailingEvent{});
+    EXPECT_THROW(manager.DispatchAllQueued(), std::runtime_error);
+
+    manager.SetParallelQueuedDispatch(false);
+
+    queue.Remove(token);
+}
+
 #endif
\ No newline at end of file
@@ -5,7 +5,9 @@
 
 #include <worm/detail/EventChannelQueue.h>
 
+#include <atomic>
 #include <chrono>
+#include <thread>
 
 TEST(EventChannelQueueTest, AddAndRemoveHandlers)
 {
@@ -80,6 +82,308 @@ TEST(EventChannelQueueTest, PostAsyncEvents)
     queue.Remove(handler);
 }
 
+TEST(EventChannelQueueTest, PostDetachedEvents)
+{
+    auto& queue = worm::detail::EventChannelQueue<TestEvent>::Instance();
+
+    MockHandler handler;
+
+    queue.Add(handler);
+
+    // Post detached asynchronous events
+    queue.PostDetached(TestEvent{ "Detached Message 1" });
+    queue.PostDetached(TestEvent{ "Detached Message 2" });
+
+    // Wait for the detached events
+    queue.DispatchAllAsync();
+
+    // Verify the messages are delivered in order
+    EXPECT_EQ(handler.GetMessages().size(), 2);
+    EXPECT_EQ(handler.GetMessages()[0], "Detached Message 1");
+    EXPECT_EQ(handler.GetMessages()[1], "Detached Message 2");
+
+    queue.Remove(handler);
+}
+
+TEST(EventChannelQueueTest, ConcurrentPostsDoNotSerialize)
+{
+    auto& queue = worm::detail::EventChannelQueue<TestEvent>::Instance();
+
+    // Handler which returns only after another thread has entered it as well
+    struct RendezvousHandler {
+        void operator()(const TestEvent&)
+        {
+            ++enteredCount;
+            const auto deadline{ std::chrono::steady_clock::now() + std::chrono::seconds(5) };
+            while (enteredCount < 2 && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        }
+
+        std::atomic<uint32_t> enteredCount{ 0 };
+    } handler;
+
+    queue.Add(handler);
+
+    std::thread poster([&queue]() { queue.Post(TestEvent{ "Message 1" }); });
+    queue.Post(TestEvent{ "Message 2" });
+    poster.join();
+
+    EXPECT_EQ(handler.enteredCount, 2);
+
+    queue.Remove(handler);
+}
+
+TEST(EventChannelQueueTest, SerializedDispatch)
+{
+    struct SerializedEvent {
+        int value;
+    };
+
+    struct CountingHandler {
+        void operator()(const SerializedEvent&)
+        {
+            const auto count{ ++concurrentCount };
+            if (count > maxConcurrentCount) {
+                maxConcurrentCount = count;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            --concurrentCount;
+            ++handledCount;
+        }
+
+        std::atomic<uint32_t> concurrentCount{ 0 };
+
+        std::atomic<uint32_t> maxConcurrentCount{ 0 };
+
+        std::atomic<uint32_t> handledCount{ 0 };
+    } handler;
+
+    auto& queue = worm::detail::EventChannelQueue<SerializedEvent>::Instance();
+    auto token = queue.Add(handler);
+
+    queue.SetSerializedDispatch(true);
+    queue.SetAsyncPolicy(worm::detail::AsyncPolicy::PARALLEL, 4, nullptr);
+
+    // ASYNC workers and SYNC posters of the type do not overlap
+    for (int i = 0; i < 20; ++i) {
+        queue.PostAsync(SerializedEvent{ i });
+    }
+    std::thread poster([&queue]() {
+        for (int i = 0; i < 20; ++i) {
+            queue.Post(SerializedEvent{ i });
+        }
+    });
+    for (int i = 0; i < 20; ++i) {
+        queue.Post(SerializedEvent{ i });
+    }
+    poster.join();
+    queue.DispatchAllAsync();
+
+    EXPECT_EQ(handler.handledCount, 60);
+    EXPECT_EQ(handler.maxConcurrentCount, 1);
+
+    queue.SetAsyncPolicy(worm::detail::AsyncPolicy::ORDERED, 0, nullptr);
+    queue.SetSerializedDispatch(false);
+    queue.Remove(token);
+}
+
+TEST(EventChannelQueueTest, RemoveHandlerDuringDispatch)
+{
+    auto& queue = worm::detail::EventChannelQueue<TestEvent>::Instance();
+
+    MockHandler removedHandler;
+
+    struct RemovingHandler {
+        void operator()(const TestEvent&)
+        {
+            if (handlerToRemove) {
+                worm::detail::EventChannelQueue<TestEvent>::Instance().Remove(*handlerToRemove);
+                handlerToRemove = nullptr;
+            }
+        }
+
+        MockHandler* handlerToRemove;
+    } removingHandler{ &removedHandler };
+
+    queue.Add(removingHandler);
+    queue.Add(removedHandler);
+
+    // The removed handler is skipped by the dispatch which is already in progress
+    queue.Post(TestEvent{ "Message" });
+    EXPECT_TRUE(removedHandler.GetMessages().empty());
+
+    queue.Remove(removingHandler);
+}
+
+TEST(EventChannelQueueTest, AsyncBatchReportsFailure)
+{
+    auto& queue = worm::detail::EventChannelQueue<TestEvent>::Instance();
+
+    MockHandler handler;
+
+    struct ThrowingHandler {
+        void operator()(const TestEvent& event)
+        {
+            if (event.message == "Failing Message") {
+                throw std::runtime_error("Handler failure");
+            }
+        }
+    } throwingHandler;
+
+    auto token = queue.Add(throwingHandler);
+    queue.Add(handler);
+
+    const std::vector<TestEvent> batch{ { "Message 1" }, { "Failing Message" }, { "Message 3" } };
+    queue.PostAsyncBatch(batch.begin(), batch.end());
+
+    // The failure is reported once the batch completes, the rest of the batch is still delivered
+    EXPECT_THROW(queue.DispatchAllAsync(), std::runtime_error);
+    const auto messages = handler.GetMessages();
+    ASSERT_FALSE(messages.empty());
+    EXPECT_EQ(messages.front(), "Message 1");
+    EXPECT_EQ(messages.back(), "Message 3");
+
+    queue.Remove(token);
+    queue.Remove(handler);
+}
+
+TEST(EventChannelQueueTest, NonBlockingAsyncCompletion)
+{
+    struct GatedEvent {
+        int value;
+    };
+
+    struct GatedHandler {
+        void operator()(const GatedEvent& event)
+        {
+            while (!isOpen.load()) {
+                std::this_thread::yield();
+            }
+            if (event.value == 1) {
+                throw std::runtime_error("Handler failure");
+            }
+            ++handledCount;
+        }
+
+        std::atomic<bool> isOpen{ false };
+
+        std::atomic<int> handledCount{ 0 };
+    } handler;
+
+    auto& queue = worm::detail::EventChannelQueue<GatedEvent>::Instance();
+    queue.Add(handler);
+
+    // Posting does not wait for the blocked handler, however many events are in flight
+    for (int i = 0; i < 5000; ++i) {
+        queue.PostAsync(GatedEvent{ i });
+    }
+    EXPECT_EQ(queue.GetPendingAsyncCount(), 5000);
+    EXPECT_FALSE(queue.PollAsync());
+    EXPECT_FALSE(queue.WaitAsync(std::chrono::steady_clock::now() + std::chrono::milliseconds{ 10 }));
+
+    // The failure is reported once, the other events are still handled
+    handler.isOpen = true;
+    EXPECT_THROW(queue.WaitAsync(std::chrono::steady_clock::now() + std::chrono::seconds{ 10 }), std::runtime_error);
+    EXPECT_TRUE(queue.PollAsync());
+    EXPECT_EQ(handler.handledCount.load(), 4999);
+    EXPECT_EQ(queue.GetPendingAsyncCount(), 0);
+
+    queue.Remove(handler);
+}
+
+TEST(EventChannelQueueTest, ParallelAsyncPolicy)
+{
+    struct ParallelEvent {
+        int value;
+    };
+
+    struct ParallelHandler {
+        void operator()(const ParallelEvent& event)
+        {
+            sum += event.value;
+        }
+
+        std::atomic<int> sum{ 0 };
+    } handler;
+
+    auto& queue = worm::detail::EventChannelQueue<ParallelEvent>::Instance();
+    auto token = queue.Add(handler);
+
+    queue.SetAsyncPolicy(worm::detail::AsyncPolicy::PARALLEL, 4, nullptr);
+
+    for (int i = 1; i <= 1000; ++i) {
+        if (i % 2 == 0) {
+            queue.PostAsync(ParallelEvent{ i });
+        } else {
+            queue.PostDetached(ParallelEvent{ i });
+        }
+    }
+    queue.DispatchAllAsync();
+
+    EXPECT_EQ(handler.sum, 500500);
+
+    queue.SetAsyncPolicy(worm::detail::AsyncPolicy::ORDERED, 0, nullptr);
+    queue.Remove(token);
+}
+
+TEST(EventChannelQueueTest, OrderedPerKeyAsyncPolicy)
+{
+    struct KeyedEvent {
+        size_t key;
+        int sequence;
+    };
+
+    struct KeyedHandler {
+        void operator()(const KeyedEvent& event)
+        {
+            std::scoped_lock lock{ mutex };
+
+            sequences[event.key].push_back(event.sequence);
+        }
+
+        std::mutex mutex;
+        std::vector<int> sequences[8];
+    } handler;
+
+    auto& queue = worm::detail::EventChannelQueue<KeyedEvent>::Instance();
+    auto token = queue.Add(handler);
+
+    // A key function is required
+    EXPECT_THROW(queue.SetAsyncPolicy(worm::detail::AsyncPolicy::ORDERED_PER_KEY, 3, nullptr), std::runtime_error);
+
+    queue.SetAsyncPolicy(worm::detail::AsyncPolicy::ORDERED_PER_KEY, 3, [](const KeyedEvent& event) { return event.key; });
+
+    std::vector<KeyedEvent> batch;
+    for (int i = 0; i < 400; ++i) {
+        if (i % 100 == 0) {
+            queue.PostAsyncBatch(batch.begin(), batch.end());
+            batch.clear();
+        }
+        const auto key = static_cast<size_t>(i % 8);
+        if (i % 3 == 0) {
+            batch.push_back(KeyedEvent{ key, i });
+        } else {
+            queue.PostDetachedBatch(batch.begin(), batch.end());
+            batch.clear();
+            queue.EmplaceAsync(key, i);
+        }
+    }
+    queue.PostAsyncBatch(batch.begin(), batch.end());
+    queue.DispatchAllAsync();
+
+    // Events of one key are handled in the posting order
+    size_t count = 0;
+    for (const auto& sequence : handler.sequences) {
+        EXPECT_TRUE(std::is_sorted(sequence.begin(), sequence.end()));
+        count += sequence.size();
+    }
+    EXPECT_EQ(count, 400);
+
+    queue.SetAsyncPolicy(worm::detail::AsyncPolicy::ORDERED, 0, nullptr);
+    queue.Remove(token);
+}
+
 TEST(EventChannelQueueTest, RemoveNonexistentHandlerThrows)
 {
     auto& queue = worm::detail::EventChannelQueue<TestEvent>::Instance();
@@ -0,0 +1,105 @@
+#ifndef __WORM_DETAIL_EVENT_LOG_TESTS_H__
+#define __WORM_DETAIL_EVENT_LOG_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/EventLog.h>
+
+#if WH_HAS_MAPPED_FILES
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using worm::detail::EventLogReader;
+using worm::detail::EventLogWriter;
+
+TEST(EventLogTest, AppendAndRead)
+{
+    const auto path{ (std::filesystem::temp_directory_path() / ("wh_event_log_test_" + std::to_string(::getpid()) + ".bin")).string() };
+    {
+        EventLogWriter writer{ path, 1024 };
+
+        const uint64_t first{ 11 };
+        const uint16_t second{ 22 };
+        EXPECT_TRUE(writer.Append(1, 100, &first, sizeof(first)));
+        EXPECT_TRUE(writer.Append(2, 200, &second, sizeof(second), 7));
+        EXPECT_EQ(writer.GetRecordCount(), 2);
+    }
+
+    EventLogReader reader{ path };
+
+    std::vector<EventLogReader::Record> records;
+    EXPECT_EQ(reader.ForEach([&](const EventLogReader::Record& record) { records.push_back(record); }), 2);
+    ASSERT_EQ(records.size(), 2);
+    EXPECT_EQ(records[0].typeTag, 1);
+    EXPECT_EQ(records[0].timestamp, 100);
+    EXPECT_EQ(records[0].payloadSize, sizeof(uint64_t));
+    EXPECT_EQ(records[0].flags, 0);
+    EXPECT_EQ(*reinterpret_cast<const uint64_t*>(records[0].payload), 11);
+    EXPECT_EQ(records[1].typeTag, 2);
+    EXPECT_EQ(records[1].payloadSize, sizeof(uint16_t));
+    EXPECT_EQ(records[1].flags, 7);
+
+    std::remove(path.c_str());
+}
+
+TEST(EventLogTest, ConcurrentAppendsAndFullLog)
+{
+    const auto path{ (std::filesystem::temp_directory_path() / ("wh_event_log_full_test_" + std::to_string(::getpid()) + ".bin")).string() };
+
+    const size_t recordSize{ worm::detail::EventLogFormat::GetRecordSize(sizeof(uint32_t)) };
+    const size_t threadCount{ 4 };
+    const uint32_t itemCount{ 100 };
+    {
+        // room for half of the records
+        EventLogWriter writer{ path, recordSize * threadCount * itemCount / 2 };
+
+        std::vector<std::thread> threads;
+        for (uint32_t thread = 0; thread < threadCount; ++thread) {
+            threads.emplace_back([&writer, thread]() {
+                for (uint32_t i = 0; i < itemCount; ++i) {
+                    writer.Append(thread, i, &i, sizeof(i));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        EXPECT_EQ(writer.GetRecordCount(), threadCount * itemCount / 2);
+        EXPECT_EQ(writer.GetDroppedCount(), threadCount * itemCount / 2);
+    }
+
+    // Records of one thread are in the appended order
+    EventLogReader reader{ path };
+    std::vector<int64_t> lastItems(threadCount, -1);
+    EXPECT_EQ(reader.ForEach([&](const EventLogReader::Record& record) {
+        const auto item{ *reinterpret_cast<const uint32_t*>(record.payload) };
+        EXPECT_GT(item, lastItems[record.typeTag]);
+        lastItems[record.typeTag] = item;
+    }),
+        threadCount * itemCount / 2);
+
+    std::remove(path.c_str());
+}
+
+TEST(EventLogTest, InvalidLog)
+{
+    const auto path{ (std::filesystem::temp_directory_path() / ("wh_event_log_invalid_test_" + std::to_string(::getpid()) + ".bin")).string() };
+    std::ofstream{ path } << "not an event log";
+
+    EXPECT_THROW(EventLogReader{ path }, std::runtime_error);
+    std::remove(path.c_str());
+
+    EXPECT_THROW(EventLogReader{ path }, std::runtime_error);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,186 @@
+#ifndef __WORM_DETAIL_MPSC_QUEUE_TESTS_H__
+#define __WORM_DETAIL_MPSC_QUEUE_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/MpscQueue.h>
+
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST(MpscQueueTest, PushAndConsume)
+{
+    worm::detail::MpscQueue<int> queue;
+
+    EXPECT_TRUE(queue.IsEmpty());
+
+    queue.Push(1);
+    queue.Push(2);
+    queue.Emplace(3);
+
+    EXPECT_FALSE(queue.IsEmpty());
+
+    // Items are consumed in FIFO order
+    std::vector<int> items;
+    EXPECT_EQ(queue.ConsumeAll([&](int item) { items.push_back(item); }), 3);
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2, 3 }));
+
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_EQ(queue.ConsumeAll([&](int item) { items.push_back(item); }), 0);
+}
+
+TEST(MpscQueueTest, ItemsPushedWhileConsumingAreLeftForNextCall)
+{
+    worm::detail::MpscQueue<int> queue;
+
+    queue.Push(1);
+    queue.Push(2);
+
+    std::vector<int> items;
+    queue.ConsumeAll([&](int item) {
+        items.push_back(item);
+        queue.Push(item + 10);
+    });
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2 }));
+
+    items.clear();
+    queue.ConsumeAll([&](int item) { items.push_back(item); });
+    EXPECT_EQ(items, (std::vector<int>{ 11, 12 }));
+}
+
+TEST(MpscQueueTest, MultipleProducers)
+{
+    worm::detail::MpscQueue<std::pair<int, int>> queue;
+
+    const int producerCount{ 4 };
+    const int itemCount{ 10000 };
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerCount; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < itemCount; ++i) {
+                queue.Emplace(p, i);
+            }
+        });
+    }
+
+    // Consume concurrently with the producers
+    std::vector<int> lastSeen(producerCount, -1);
+    size_t consumed{ 0 };
+    auto consumer = [&](const std::pair<int, int>& item) {
+        // Order of items from a single producer is preserved
+        EXPECT_EQ(lastSeen[item.first] + 1, item.second);
+        lastSeen[item.first] = item.second;
+    };
+
+    while (consumed < producerCount * itemCount / 2) {
+        consumed += queue.ConsumeAll(consumer);
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    while (!queue.IsEmpty()) {
+        consumed += queue.ConsumeAll(consumer);
+    }
+
+    EXPECT_EQ(consumed, producerCount * itemCount);
+}
+
+struct StubRaceItem {
+    int value;
+};
+
+// Pushes an item at the moment the consumer re-inserts the stub behind the last item
+template <>
+struct worm::detail::MpscQueueStubHook<StubRaceItem> {
+    static void BeforeStubPush(worm::detail::MpscQueue<StubRaceItem>& queue)
+    {
+        if (racingValue) {
+            queue.Push(StubRaceItem{ *std::exchange(racingValue, std::nullopt) });
+        }
+    }
+
+    static inline std::optional<int> racingValue;
+};
+
+TEST(MpscQueueTest, PushRacingTheLastPopIsNotStranded)
+{
+    using Hook = worm::detail::MpscQueueStubHook<StubRaceItem>;
+
+    worm::detail::MpscQueue<StubRaceItem> queue;
+
+    std::vector<int> items;
+    auto consumer = [&](const StubRaceItem& item) { items.push_back(item.value); };
+
+    queue.Push(StubRaceItem{ 1 });
+    Hook::racingValue = 2;
+    EXPECT_EQ(queue.ConsumeAll(consumer), 1);
+    EXPECT_FALSE(Hook::racingValue.has_value());
+
+    // The racing item lands in front of the stub, it is neither reported empty nor skipped by the next call
+    EXPECT_FALSE(queue.IsEmpty());
+    EXPECT_EQ(queue.ConsumeAll(consumer), 1);
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2 }));
+    EXPECT_TRUE(queue.IsEmpty());
+    EXPECT_EQ(queue.ConsumeAll(consumer), 0);
+
+    // The same with the next push linking behind the stub
+    queue.Push(StubRaceItem{ 3 });
+    Hook::racingValue = 4;
+    EXPECT_EQ(queue.ConsumeAll(consumer), 1);
+    queue.Push(StubRaceItem{ 5 });
+    EXPECT_EQ(queue.ConsumeAll(consumer), 2);
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2, 3, 4, 5 }));
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+TEST(MpscQueueTest, PushRange)
+{
+    worm::detail::MpscQueue<int> queue;
+
+    const std::vector<int> batch{ 2, 3, 4 };
+
+    queue.Push(1);
+    queue.PushRange(batch.begin(), batch.end());
+    queue.PushRange(batch.end(), batch.end());
+    queue.Push(5);
+
+    std::vector<int> items;
+    EXPECT_EQ(queue.ConsumeAll([&](int item) { items.push_back(item); }), 5);
+    EXPECT_EQ(items, (std::vector<int>{ 1, 2, 3, 4, 5 }));
+}
+
+TEST(MpscQueueTest, DestroyNonEmpty)
+{
+    auto queue = std::make_unique<worm::detail::MpscQueue<std::string>>();
+
+    queue->Push("Message 1");
+    queue->Push("Message 2");
+
+    // Remaining items are released with the queue
+    queue.reset();
+    EXPECT_EQ(queue, nullptr);
+}
+
+TEST(MpscQueueTest, ConsumeLimited)
+{
+    worm::detail::MpscQueue<int> queue;
+
+    for (int i = 0; i < 5; ++i) {
+        queue.Push(i);
+    }
+
+    // The rest is left for the next call
+    std::vector<int> items;
+    EXPECT_EQ(queue.Consume(2, [&](int item) { items.push_back(item); }), 2);
+    EXPECT_EQ(items, (std::vector<int>{ 0, 1 }));
+    EXPECT_EQ(queue.Consume(0, [&](int item) { items.push_back(item); }), 0);
+    EXPECT_EQ(queue.Consume(10, [&](int item) { items.push_back(item); }), 3);
+    EXPECT_EQ(items, (std::vector<int>{ 0, 1, 2, 3, 4 }));
+}
+
+#endif
@@ -0,0 +1,121 @@
+#ifndef __WORM_DETAIL_PRODUCER_BUFFERED_QUEUE_TESTS_H__
+#define __WORM_DETAIL_PRODUCER_BUFFERED_QUEUE_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/ProducerBufferedQueue.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using worm::detail::ProducerBufferedQueue;
+
+TEST(ProducerBufferedQueueTest, PerProducerOrder)
+{
+    ProducerBufferedQueue<std::pair<int, int>> queue;
+
+    const int producerCount = 4;
+    const int itemCount = 10000;
+
+    std::atomic<bool> done{ false };
+    std::vector<int> lastItems(producerCount, -1);
+    size_t consumedCount = 0;
+    const auto consumer = [&](const std::pair<int, int>& item) {
+        // Items of one producer come in the pushed order
+        EXPECT_EQ(item.second, lastItems[item.first] + 1);
+        lastItems[item.first] = item.second;
+        ++consumedCount;
+    };
+
+    std::thread consumerThread([&]() {
+        while (!done.load()) {
+            queue.ConsumeAll(consumer);
+        }
+        queue.ConsumeAll(consumer);
+    });
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < producerCount; ++producer) {
+        producers.emplace_back([&queue, producer]() {
+            for (int i = 0; i < itemCount; ++i) {
+                queue.Emplace(producer, i);
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    done.store(true);
+    consumerThread.join();
+
+    EXPECT_EQ(consumedCount, producerCount * itemCount);
+    EXPECT_TRUE(queue.IsEmpty());
+
+    // The buffers of the exited producers are reused
+    std::thread([&queue]() { queue.Emplace(0, 0); }).join();
+    EXPECT_LE(queue.GetBufferCount(), producerCount);
+}
+
+TEST(ProducerBufferedQueueTest, PushRangeAndConsumerException)
+{
+    ProducerBufferedQueue<int> queue;
+
+    std::vector<int> items(600);
+    for (size_t i = 0; i < items.size(); ++i) {
+        items[i] = static_cast<int>(i);
+    }
+    queue.PushRange(items.begin(), items.end());
+
+    std::vector<int> consumed;
+    const auto consumer = [&](int item) {
+        if (item == 300 && consumed.size() == 300) {
+            consumed.push_back(-1);
+            throw std::runtime_error("Consumer failed");
+        }
+        consumed.push_back(item);
+    };
+
+    EXPECT_THROW(queue.ConsumeAll(consumer), std::runtime_error);
+
+    // The failed item is not consumed again
+    EXPECT_EQ(queue.ConsumeAll(consumer), 299);
+    ASSERT_EQ(consumed.size(), 600);
+    EXPECT_EQ(consumed[300], -1);
+    EXPECT_EQ(consumed.back(), 599);
+}
+
+TEST(ProducerBufferedQueueTest, ConsumeLimitedResumesWithNextBuffer)
+{
+    ProducerBufferedQueue<std::pair<int, int>> queue;
+
+    for (int i = 0; i < 3; ++i) {
+        queue.Emplace(0, i);
+    }
+    std::thread([&queue]() {
+        for (int i = 0; i < 3; ++i) {
+            queue.Emplace(1, i);
+        }
+    }).join();
+    EXPECT_EQ(queue.GetBufferCount(), 2);
+
+    std::vector<std::pair<int, int>> items;
+    const auto consumer{ [&](const std::pair<int, int>& item) { items.push_back(item); } };
+
+    // Both producers get their turn
+    EXPECT_EQ(queue.Consume(2, consumer), 2);
+    EXPECT_EQ(queue.Consume(2, consumer), 2);
+    ASSERT_EQ(items.size(), 4);
+    EXPECT_NE(items[0].first, items[2].first);
+    EXPECT_EQ(items[1], std::make_pair(items[0].first, 1));
+    EXPECT_EQ(items[3], std::make_pair(items[2].first, 1));
+
+    EXPECT_EQ(queue.Consume(10, consumer), 2);
+    EXPECT_EQ(items[4], std::make_pair(items[0].first, 2));
+    EXPECT_EQ(items[5], std::make_pair(items[2].first, 2));
+    EXPECT_TRUE(queue.IsEmpty());
+}
+
+#endif
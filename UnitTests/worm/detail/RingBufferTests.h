@@ -96,4 +96,26 @@ TEST(RingBufferTest, NonCopyableType)
     EXPECT_TRUE(buffer.IsEmpty());
 }
 
+TEST(RingBufferTest, RuntimeCapacity)
+{
+    worm::detail::RingBuffer<std::string, 0> buffer(3);
+
+    EXPECT_EQ(buffer.Capacity(), 3);
+
+    buffer.Push("1");
+    buffer.Push("2");
+    buffer.Push("3");
+
+    EXPECT_TRUE(buffer.IsFull());
+    EXPECT_THROW(buffer.Push("4"), std::runtime_error);
+
+    // Wraps around like the fixed size buffer
+    EXPECT_EQ(buffer.Pop(), "1");
+    buffer.Push("4");
+    EXPECT_EQ(buffer.Pop(), "2");
+    EXPECT_EQ(buffer.Pop(), "3");
+    EXPECT_EQ(buffer.Pop(), "4");
+    EXPECT_TRUE(buffer.IsEmpty());
+}
+
 #endif
\ No newline at end of file
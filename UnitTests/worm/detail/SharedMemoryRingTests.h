@@ -0,0 +1,77 @@
+#ifndef __WORM_DETAIL_SHARED_MEMORY_RING_TESTS_H__
+#define __WORM_DETAIL_SHARED_MEMORY_RING_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/SharedMemoryRing.h>
+
+#if WH_HAS_SHARED_MEMORY
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using worm::detail::SharedMemoryRing;
+
+inline std::string GetSharedMemoryTestName(const std::string& test)
+{
+    return "/wh_" + test + "_" + std::to_string(::getpid());
+}
+
+TEST(SharedMemoryRingTest, PushAndConsumeThroughSecondMapping)
+{
+    const auto name{ GetSharedMemoryTestName("ring") };
+
+    SharedMemoryRing<int> consumer{ name, 4 };
+    SharedMemoryRing<int> producer{ name };
+
+    EXPECT_EQ(producer.Capacity(), 4);
+    EXPECT_TRUE(consumer.IsEmpty());
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(producer.TryPush(i));
+    }
+    EXPECT_FALSE(producer.TryPush(4));
+
+    std::vector<int> items;
+    EXPECT_EQ(consumer.ConsumeAll([&](const int& item) { items.push_back(item); }), 4);
+    EXPECT_EQ(items, (std::vector<int>{ 0, 1, 2, 3 }));
+    EXPECT_TRUE(consumer.IsEmpty());
+
+    // The consumed slots are reused
+    EXPECT_TRUE(producer.TryPush(4));
+    EXPECT_EQ(consumer.ConsumeAll([&](const int& item) { items.push_back(item); }), 1);
+    EXPECT_EQ(items.back(), 4);
+}
+
+TEST(SharedMemoryRingTest, ConsumerExceptionReleasesSlot)
+{
+    SharedMemoryRing<int> ring{ GetSharedMemoryTestName("ring_exception"), 2 };
+
+    ring.TryPush(1);
+    ring.TryPush(2);
+
+    EXPECT_THROW(ring.ConsumeAll([](const int&) { throw std::runtime_error("Consumer failed"); }), std::runtime_error);
+
+    std::vector<int> items;
+    EXPECT_EQ(ring.ConsumeAll([&](const int& item) { items.push_back(item); }), 1);
+    EXPECT_EQ(items, (std::vector<int>{ 2 }));
+}
+
+TEST(SharedMemoryRingTest, InvalidRings)
+{
+    const auto name{ GetSharedMemoryTestName("ring_invalid") };
+
+    EXPECT_THROW((SharedMemoryRing<int>{ name, 3 }), std::runtime_error);
+    EXPECT_THROW(SharedMemoryRing<int>{ name }, std::runtime_error);
+
+    SharedMemoryRing<int> ring{ name, 8 };
+
+    // The name is taken and the item layout differs
+    EXPECT_THROW((SharedMemoryRing<int>{ name, 8 }), std::runtime_error);
+    EXPECT_THROW(SharedMemoryRing<double>{ name }, std::runtime_error);
+}
+
+#endif
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef __WORM_DETAIL_SLOT_MAP_TESTS_H__
+#define __WORM_DETAIL_SLOT_MAP_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/SlotMap.h>
+
+#include <string>
+
+TEST(SlotMapTest, EmplaceAndErase)
+{
+    worm::detail::SlotMap<std::string> slotMap;
+
+    auto handle1 = slotMap.Emplace("first");
+    auto handle2 = slotMap.Emplace("second");
+
+    EXPECT_TRUE(handle1.IsValid());
+    EXPECT_NE(handle1, handle2);
+    EXPECT_EQ(slotMap.Size(), 2);
+    EXPECT_EQ(*slotMap.Get(handle1), "first");
+    EXPECT_EQ(*slotMap.Get(handle2), "second");
+
+    EXPECT_TRUE(slotMap.Erase(handle1));
+    EXPECT_FALSE(slotMap.Contains(handle1));
+    EXPECT_EQ(slotMap.Get(handle1), nullptr);
+    EXPECT_EQ(slotMap.Size(), 1);
+
+    // Erasing twice fails
+    EXPECT_FALSE(slotMap.Erase(handle1));
+    EXPECT_FALSE(slotMap.Erase(worm::detail::SlotHandle{}));
+}
+
+TEST(SlotMapTest, StaleHandleAfterSlotReuse)
+{
+    worm::detail::SlotMap<int> slotMap;
+
+    auto handle1 = slotMap.Emplace(1);
+    const auto& generation = slotMap.GetGeneration(handle1.index);
+    EXPECT_EQ(generation.load(), handle1.generation);
+
+    slotMap.Erase(handle1);
+    EXPECT_NE(generation.load(), handle1.generation);
+
+    // The slot is reused with a new generation
+    auto handle2 = slotMap.Emplace(2);
+    EXPECT_EQ(handle2.index, handle1.index);
+    EXPECT_NE(handle2.generation, handle1.generation);
+    EXPECT_FALSE(slotMap.Contains(handle1));
+    EXPECT_EQ(*slotMap.Get(handle2), 2);
+    EXPECT_EQ(&slotMap.GetGeneration(handle2.index), &generation);
+}
+
+TEST(SlotMapTest, ForEachVisitsLiveValues)
+{
+    worm::detail::SlotMap<int> slotMap;
+
+    std::vector<worm::detail::SlotHandle> handles;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(slotMap.Emplace(i));
+    }
+
+    for (int i = 0; i < 1000; i += 2) {
+        slotMap.Erase(handles[i]);
+    }
+
+    int count = 0;
+    int sum = 0;
+    slotMap.ForEach([&](const worm::detail::SlotHandle& handle, const int& value) {
+        EXPECT_TRUE(slotMap.Contains(handle));
+        EXPECT_EQ(value % 2, 1);
+        ++count;
+        sum += value;
+    });
+
+    EXPECT_EQ(count, 500);
+    EXPECT_EQ(sum, 250000);
+}
+
+#endif
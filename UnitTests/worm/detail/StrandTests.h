@@ -0,0 +1,167 @@
+#ifndef __WORM_DETAIL_STRAND_TESTS_H__
+#define __WORM_DETAIL_STRAND_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/Strand.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+struct StrandTestContext {
+    std::vector<int> items;
+
+    std::atomic<uint32_t> concurrentCount{ 0 };
+
+    std::atomic<uint32_t> maxConcurrentCount{ 0 };
+
+    static void Handle(void* context, int& item)
+    {
+        auto& self{ *static_cast<StrandTestContext*>(context) };
+
+        const auto count{ ++self.concurrentCount };
+        if (count > self.maxConcurrentCount) {
+            self.maxConcurrentCount = count;
+        }
+
+        self.items.push_back(item);
+
+        --self.concurrentCount;
+    }
+};
+
+TEST(StrandTest, ItemsAreHandledInOrder)
+{
+    worm::detail::WorkStealingExecutor executor(4);
+
+    StrandTestContext context;
+    {
+        worm::detail::Strand<int> strand{ executor, &StrandTestContext::Handle, &context };
+
+        for (int i = 0; i < 1000; ++i) {
+            strand.Emplace(i);
+        }
+
+        // Strand waits for all its items before it is destroyed
+    }
+
+    ASSERT_EQ(context.items.size(), 1000);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(context.items[i], i);
+    }
+    EXPECT_EQ(context.maxConcurrentCount, 1);
+}
+
+TEST(StrandTest, MultipleStrandsShareExecutor)
+{
+    worm::detail::WorkStealingExecutor executor(2);
+
+    std::vector<std::unique_ptr<StrandTestContext>> contexts;
+    std::vector<std::unique_ptr<worm::detail::Strand<int>>> strands;
+    for (int i = 0; i < 8; ++i) {
+        contexts.emplace_back(std::make_unique<StrandTestContext>());
+        strands.emplace_back(std::make_unique<worm::detail::Strand<int>>(executor, &StrandTestContext::Handle, contexts.back().get()));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        for (auto& strand : strands) {
+            strand->Emplace(i);
+        }
+    }
+
+    strands.clear();
+
+    for (const auto& context : contexts) {
+        ASSERT_EQ(context->items.size(), 100);
+        for (int i = 0; i < 100; ++i) {
+            EXPECT_EQ(context->items[i], i);
+        }
+    }
+}
+
+TEST(StrandTest, WaitForPendingItems)
+{
+    worm::detail::WorkStealingExecutor executor(2);
+
+    StrandTestContext context;
+    worm::detail::Strand<int> strand{ executor, &StrandTestContext::Handle, &context, 4 };
+
+    // Post more items than the initial capacity
+    for (int i = 0; i < 100; ++i) {
+        strand.Emplace(i);
+    }
+
+    strand.Wait();
+
+    EXPECT_EQ(strand.GetPendingCount(), 0);
+    EXPECT_EQ(context.items.size(), 100);
+
+    // Waiting on an idle strand returns right away
+    strand.Wait();
+}
+
+struct RepostingStrandContext {
+    worm::detail::Strand<int>* strand{ nullptr };
+
+    std::atomic<bool> stop{ false };
+
+    std::atomic<int> handledCount{ 0 };
+
+    static void Handle(void* context, int& item)
+    {
+        auto& self{ *static_cast<RepostingStrandContext*>(context) };
+
+        ++self.handledCount;
+        if (!self.stop) {
+            self.strand->Emplace(item + 1);
+        }
+    }
+};
+
+TEST(StrandTest, WaitIgnoresLaterItems)
+{
+    worm::detail::WorkStealingExecutor executor(2);
+
+    RepostingStrandContext context;
+    worm::detail::Strand<int> strand{ executor, &RepostingStrandContext::Handle, &context };
+    context.strand = &strand;
+
+    // Every handled item posts another one, so the strand is never idle
+    strand.Emplace(0);
+    strand.Wait();
+    EXPECT_GE(context.handledCount, 1);
+
+    EXPECT_TRUE(strand.WaitUntil(std::chrono::steady_clock::now() + std::chrono::seconds{ 10 }));
+
+    context.stop = true;
+}
+
+struct ThrowingStrandItem {
+    explicit ThrowingStrandItem(const bool fail)
+    {
+        if (fail) {
+            throw std::runtime_error("Construction failed");
+        }
+    }
+};
+
+TEST(StrandTest, FailedEmplaceIsNotPending)
+{
+    worm::detail::WorkStealingExecutor executor(1);
+
+    int handledCount{ 0 };
+    worm::detail::Strand<ThrowingStrandItem> strand{ executor, [](void* context, ThrowingStrandItem&) { ++*static_cast<int*>(context); }, &handledCount };
+
+    EXPECT_THROW(strand.Emplace(true), std::runtime_error);
+    EXPECT_EQ(strand.GetPendingCount(), 0);
+    EXPECT_TRUE(strand.WaitUntil(std::chrono::steady_clock::now()));
+
+    strand.Emplace(false);
+    strand.Wait();
+    EXPECT_EQ(strand.GetPendingCount(), 0);
+    EXPECT_EQ(handledCount, 1);
+}
+
+#endif
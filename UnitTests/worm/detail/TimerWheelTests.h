@@ -0,0 +1,97 @@
+#ifndef __WORM_DETAIL_TIMER_WHEEL_TESTS_H__
+#define __WORM_DETAIL_TIMER_WHEEL_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/TimerWheel.h>
+
+#include <cstdint>
+#include <vector>
+
+TEST(TimerWheelTest, TimersFireAtTheirTicksAcrossLevels)
+{
+    worm::detail::TimerWheel<uint64_t> wheel;
+
+    const std::vector<uint64_t> ticks{ 1, 255, 256, 257, 1000, 65535, 65536, 70000, 16777216, 20000000 };
+    for (auto it = ticks.rbegin(); it != ticks.rend(); ++it) {
+        wheel.Schedule(*it, *it);
+    }
+    EXPECT_EQ(wheel.Size(), ticks.size());
+
+    // Every timer becomes due exactly at its tick
+    std::vector<uint64_t> fired;
+    for (const auto tick : ticks) {
+        EXPECT_EQ(wheel.Advance(tick - 1), 0);
+        EXPECT_EQ(wheel.Advance(tick), 1);
+        fired.push_back(*wheel.PopDue());
+        EXPECT_FALSE(wheel.PopDue().has_value());
+    }
+    EXPECT_EQ(fired, ticks);
+    EXPECT_EQ(wheel.Size(), 0);
+    EXPECT_EQ(wheel.GetCurrentTick(), ticks.back());
+}
+
+TEST(TimerWheelTest, DueTimersInTickOrder)
+{
+    worm::detail::TimerWheel<int> wheel{ 100 };
+
+    wheel.Schedule(300, 3);
+    wheel.Schedule(150, 2);
+    wheel.Schedule(101, 1);
+
+    // A timer in the past is due right away
+    wheel.Schedule(50, 0);
+    EXPECT_EQ(wheel.Advance(100), 1);
+
+    EXPECT_EQ(wheel.Advance(1000), 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(wheel.PopDue(), i);
+    }
+    EXPECT_FALSE(wheel.PopDue().has_value());
+}
+
+TEST(TimerWheelTest, CancelledTimersDoNotFire)
+{
+    worm::detail::TimerWheel<int> wheel;
+
+    std::vector<worm::detail::SlotHandle> handles;
+    for (int i = 0; i < 1000; ++i) {
+        handles.push_back(wheel.Schedule(static_cast<uint64_t>(i) * 97 + 1, i));
+    }
+    for (size_t i = 0; i < handles.size(); i += 2) {
+        EXPECT_TRUE(wheel.Cancel(handles[i]));
+    }
+    EXPECT_EQ(wheel.Size(), 500);
+
+    // A cancelled or fired timer cannot be cancelled again
+    EXPECT_FALSE(wheel.Cancel(handles[0]));
+
+    // A due timer can be cancelled until it is popped
+    EXPECT_EQ(wheel.Advance(97 * 1000), 500);
+    EXPECT_TRUE(wheel.Cancel(handles[1]));
+    for (int i = 3; i < 1000; i += 2) {
+        EXPECT_EQ(wheel.PopDue(), i);
+    }
+    EXPECT_FALSE(wheel.Cancel(handles[3]));
+    EXPECT_EQ(wheel.Size(), 0);
+}
+
+TEST(TimerWheelTest, TimersBeyondTheTopLevel)
+{
+    worm::detail::TimerWheel<int> wheel;
+
+    const auto farTick = (uint64_t{ 1 } << 40) + 5;
+    wheel.Schedule(farTick, 1);
+    wheel.Schedule(10, 0);
+
+    EXPECT_EQ(wheel.Advance(10), 1);
+    EXPECT_EQ(wheel.PopDue(), 0);
+
+    // Empty stretches are skipped, the parked timer is moved down on the way
+    EXPECT_EQ(wheel.Advance(farTick - 1), 0);
+    EXPECT_EQ(wheel.Advance(farTick), 1);
+    EXPECT_EQ(wheel.PopDue(), 1);
+    EXPECT_EQ(wheel.GetCurrentTick(), farTick);
+}
+
+#endif
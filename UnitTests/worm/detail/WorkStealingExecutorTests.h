@@ -0,0 +1,103 @@
+#ifndef __WORM_DETAIL_WORK_STEALING_EXECUTOR_TESTS_H__
+#define __WORM_DETAIL_WORK_STEALING_EXECUTOR_TESTS_H__
+
+#include "../Common.h"
+
+#include <worm/detail/WorkStealingExecutor.h>
+
+#include <atomic>
+#include <set>
+#include <thread>
+
+struct ExecutorTestContext {
+    std::atomic<uint32_t> counter{ 0 };
+
+    std::mutex mutex;
+
+    std::set<std::thread::id> threadIds;
+
+    static void Increment(void* context)
+    {
+        auto& self{ *static_cast<ExecutorTestContext*>(context) };
+
+        {
+            std::scoped_lock lock{ self.mutex };
+            self.threadIds.insert(std::this_thread::get_id());
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+        ++self.counter;
+    }
+};
+
+TEST(WorkStealingExecutorTest, ZeroWorkers)
+{
+    EXPECT_THROW(worm::detail::WorkStealingExecutor executor(0), std::runtime_error);
+}
+
+TEST(WorkStealingExecutorTest, ExecuteTasks)
+{
+    ExecutorTestContext context;
+    {
+        worm::detail::WorkStealingExecutor executor(4);
+        EXPECT_EQ(executor.GetWorkerCount(), 4);
+
+        for (uint32_t i = 0; i < 1000; ++i) {
+            executor.Submit({ &ExecutorTestContext::Increment, &context });
+        }
+    }
+
+    // Executor finishes all submitted tasks before it is destroyed
+    EXPECT_EQ(context.counter, 1000);
+    EXPECT_LE(context.threadIds.size(), 4);
+    EXPECT_EQ(context.threadIds.count(std::this_thread::get_id()), 0);
+}
+
+TEST(WorkStealingExecutorTest, SetWorkerCountBeforeStart)
+{
+    worm::detail::WorkStealingExecutor executor(1);
+
+    executor.SetWorkerCount(3);
+    EXPECT_EQ(executor.GetWorkerCount(), 3);
+
+    EXPECT_THROW(executor.SetWorkerCount(0), std::runtime_error);
+
+    ExecutorTestContext context;
+    executor.Submit({ &ExecutorTestContext::Increment, &context });
+
+    // Workers are running now
+    EXPECT_THROW(executor.SetWorkerCount(2), std::runtime_error);
+
+    while (context.counter == 0) {
+        std::this_thread::yield();
+    }
+}
+
+TEST(WorkStealingExecutorTest, SubmitFromWorker)
+{
+    struct RecursiveContext {
+        worm::detail::WorkStealingExecutor* executor;
+
+        std::atomic<uint32_t> remaining{ 100 };
+
+        static void Run(void* context)
+        {
+            auto& self{ *static_cast<RecursiveContext*>(context) };
+            if (--self.remaining > 0) {
+                self.executor->Submit({ &RecursiveContext::Run, &self });
+            }
+        }
+    };
+
+    RecursiveContext context;
+    {
+        worm::detail::WorkStealingExecutor executor(2);
+        context.executor = &executor;
+
+        executor.Submit({ &RecursiveContext::Run, &context });
+    }
+
+    EXPECT_EQ(context.remaining, 0);
+}
+
+#endif
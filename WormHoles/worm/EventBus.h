@@ -0,0 +1,412 @@
+#ifndef __WH_EVENT_BUS_H__
+#define __WH_EVENT_BUS_H__
+
+#include "detail/ChannelRegistry.h"
+#include "detail/Construct.h"
+#include "detail/EventChannelQueue.h"
+#include "detail/EventChannelQueueManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace worm {
+using DispatchType = detail::DispatchType;
+
+using SubscriptionToken = detail::SlotHandle;
+
+using ChannelMetrics = detail::ChannelMetricsSnapshot;
+
+using OverflowPolicy = detail::OverflowPolicy;
+
+using AsyncPolicy = detail::AsyncPolicy;
+
+using Priority = detail::Priority;
+
+using QueuedAllocation = detail::QueuedAllocation;
+
+using AllocatorStats = detail::AllocatorStats;
+
+using DispatchBudget = detail::DispatchBudget;
+
+using TimerToken = detail::SlotHandle;
+
+// Owns its channels, dispatch manager and async workers, so every subsystem can run an isolated bus on its own thread.
+// Posting and dispatching do not share any locks between buses, only the subscription changes of all the buses
+// retire the replaced handler lists through the process-wide epoch domain and its lock.
+// DispatchAllQueued of a bus dispatches only the messages posted to that bus.
+// The static EventChannel API uses the default bus.
+class EventBus final {
+public:
+    explicit EventBus(const size_t asyncWorkerCount = std::max<size_t>(1, std::thread::hardware_concurrency()))
+        : m_ownedManager{ std::make_unique<detail::EventChannelQueueManager>(asyncWorkerCount) }
+        , m_manager{ *m_ownedManager }
+        , m_isDefault{ false }
+    {
+    }
+
+    // The channels are destroyed before the manager, pending ASYNC messages are handled first.
+    ~EventBus() = default;
+
+public:
+    // The process-wide bus, its channels are shared with the static EventChannel API.
+    static EventBus& GetDefault()
+    {
+        static EventBus bus{ DefaultTag{} };
+        return bus;
+    }
+
+public:
+    template <typename MessageType, typename EventHandlerType>
+    SubscriptionToken Add(EventHandlerType& handler)
+    {
+        return GetChannel<MessageType>().Add(handler);
+    }
+
+    // The handler receives only messages with the routing key, the routing key function has to be set first.
+    template <typename MessageType, typename EventHandlerType>
+    SubscriptionToken Add(EventHandlerType& handler, const size_t routingKey)
+    {
+        return GetChannel<MessageType>().Add(handler, routingKey);
+    }
+
+    // Extracts the routing key of the messages, so that a message is dispatched only to the handlers added with its key
+    // and to the handlers added without a key. nullptr turns the routing off (default).
+    template <typename MessageType>
+    void SetRoutingKeyFunction(const typename detail::EventChannelQueue<MessageType>::KeyFunction keyFunction)
+    {
+        GetChannel<MessageType>().SetRoutingKeyFunction(keyFunction);
+    }
+
+    // O(1) removal by the token returned from Add.
+    template <typename MessageType>
+    void Remove(const SubscriptionToken token)
+    {
+        GetChannel<MessageType>().Remove(token);
+    }
+
+    template <typename MessageType, typename EventHandlerType>
+    void Remove(EventHandlerType& handler)
+    {
+        GetChannel<MessageType>().Remove(handler);
+    }
+
+    // Returns false only if a bounded QUEUED channel with the FAIL policy rejected the message.
+    // The priority applies to QUEUED messages only.
+    template <typename MessageType>
+    bool Post(const MessageType& message, const DispatchType dispatchType = DispatchType::SYNC, const Priority priority = Priority::NORMAL)
+    {
+        auto& channel{ GetChannel<MessageType>() };
+        channel.NotifyPosted(message, dispatchType, priority);
+
+        switch (dispatchType) {
+        case DispatchType::ASYNC:
+            channel.PostAsync(message);
+            break;
+        case DispatchType::QUEUED:
+            return channel.PostQueued(message, priority);
+        case DispatchType::ASYNC_DETACHED:
+            channel.PostDetached(message);
+            break;
+        default:
+            channel.Post(message);
+            break;
+        }
+        return true;
+    }
+
+    template <typename MessageType, typename = std::enable_if_t<!std::is_reference_v<MessageType>>>
+    bool Post(MessageType&& message, const DispatchType dispatchType = DispatchType::SYNC, const Priority priority = Priority::NORMAL)
+    {
+        auto& channel{ GetChannel<MessageType>() };
+        channel.NotifyPosted(message, dispatchType, priority);
+
+        switch (dispatchType) {
+        case DispatchType::ASYNC:
+            channel.PostAsync(std::move(message));
+            break;
+        case DispatchType::QUEUED:
+            return channel.PostQueued(std::move(message), priority);
+        case DispatchType::ASYNC_DETACHED:
+            channel.PostDetached(std::move(message));
+            break;
+        default:
+            channel.Post(message);
+            break;
+        }
+        return true;
+    }
+
+    // Constructs the message directly in the queue storage of the channel.
+    template <typename MessageType, typename... Args>
+    bool Emplace(const DispatchType dispatchType, Args&&... args)
+    {
+        auto& channel{ GetChannel<MessageType>() };
+        if (channel.HasPostObserver()) {
+            // the observer needs the message before it is queued
+            return Post(detail::Construct<MessageType>(std::forward<Args>(args)...), dispatchType);
+        }
+
+        switch (dispatchType) {
+        case DispatchType::ASYNC:
+            channel.EmplaceAsync(std::forward<Args>(args)...);
+            break;
+        case DispatchType::QUEUED:
+            return channel.EmplaceQueued(std::forward<Args>(args)...);
+        case DispatchType::ASYNC_DETACHED:
+            channel.EmplaceDetached(std::forward<Args>(args)...);
+            break;
+        default:
+            channel.Post(detail::Construct<MessageType>(std::forward<Args>(args)...));
+            break;
+        }
+        return true;
+    }
+
+    // Posts all the messages of the range at once - QUEUED messages are published atomically and ASYNC ones are
+    // handled by a single task. Pass move iterators to move the messages into the channel.
+    // Returns the number of accepted messages.
+    template <typename MessageType, typename IteratorType>
+    size_t PostBatch(IteratorType first, IteratorType last, const DispatchType dispatchType = DispatchType::SYNC, const Priority priority = Priority::NORMAL)
+    {
+        const auto count{ static_cast<size_t>(std::distance(first, last)) };
+
+        auto& channel{ GetChannel<MessageType>() };
+        if (channel.HasPostObserver()) {
+            for (auto it{ first }; it != last; ++it) {
+                channel.NotifyPosted(*it, dispatchType, priority);
+            }
+        }
+
+        switch (dispatchType) {
+        case DispatchType::ASYNC:
+            channel.PostAsyncBatch(first, last);
+            break;
+        case DispatchType::QUEUED:
+            return channel.PostQueuedBatch(first, last, priority);
+        case DispatchType::ASYNC_DETACHED:
+            channel.PostDetachedBatch(first, last);
+            break;
+        default:
+            channel.PostBatch(first, last);
+            break;
+        }
+        return count;
+    }
+
+    // Posts the message with the dispatch type once the delay has passed. Due messages are posted whenever the timers
+    // are advanced - by DispatchAllQueued, DispatchAll or AdvanceTimers - so a due QUEUED message is dispatched by
+    // the same DispatchAllQueued call. The timers have a resolution of 1 ms and never fire early.
+    template <typename MessageType>
+    TimerToken PostDelayed(MessageType message, const std::chrono::steady_clock::duration delay, const DispatchType dispatchType = DispatchType::QUEUED, const Priority priority = Priority::NORMAL)
+    {
+        return PostAt(std::move(message), std::chrono::steady_clock::now() + delay, dispatchType, priority);
+    }
+
+    template <typename MessageType>
+    TimerToken PostAt(MessageType message, const std::chrono::steady_clock::time_point deadline, const DispatchType dispatchType = DispatchType::QUEUED, const Priority priority = Priority::NORMAL)
+    {
+        return GetChannel<MessageType>().PostAt(deadline, dispatchType, priority, std::move(message));
+    }
+
+    // Returns false if the message has already been posted or the timer has been cancelled.
+    template <typename MessageType>
+    bool CancelTimer(const TimerToken token)
+    {
+        return GetChannel<MessageType>().CancelTimer(token);
+    }
+
+    // Posts the due delayed messages of all the channels of the bus.
+    void AdvanceTimers()
+    {
+        m_manager.AdvanceTimers();
+    }
+
+    void DispatchAllQueued()
+    {
+        m_manager.DispatchAllQueued();
+    }
+
+    // Dispatches the queued messages until the budget - a number of messages or a deadline - runs out, e.g. to bound
+    // the pause of a frame loop. The channels take turns in small slices and the next call continues where this one
+    // stopped, the parallel dispatch does not apply. Returns the number of dispatched messages.
+    size_t DispatchAllQueued(const DispatchBudget& budget)
+    {
+        return m_manager.DispatchAllQueued(budget);
+    }
+
+    // Queued messages of all the channels of the bus waiting for the dispatch.
+    uint64_t GetQueuedBacklog()
+    {
+        return m_manager.GetQueuedBacklog();
+    }
+
+    void DispatchAllAsync()
+    {
+        m_manager.DispatchAllAsync();
+    }
+
+    // Posting ASYNC events never waits for the handlers. The completion is checked without blocking by PollAsync or
+    // with a bounded wait by WaitAsync, both return true once all the async events have been handled and rethrow
+    // the first unreported failure of an ASYNC handler of a channel.
+    bool PollAsync()
+    {
+        return m_manager.PollAsync();
+    }
+
+    bool WaitAsync(const std::chrono::steady_clock::duration timeout)
+    {
+        return m_manager.WaitAsync(timeout);
+    }
+
+    uint64_t GetPendingAsyncCount()
+    {
+        return m_manager.GetPendingAsyncCount();
+    }
+
+    void DispatchAll()
+    {
+        m_manager.DispatchAll();
+    }
+
+    // Limits the number of QUEUED messages of the type waiting for the dispatch, 0 means unbounded (default).
+    // Must be called while no messages of the type are queued.
+    template <typename MessageType>
+    void SetQueuedCapacity(const size_t capacity, const OverflowPolicy policy = OverflowPolicy::BLOCK)
+    {
+        GetChannel<MessageType>().SetQueuedCapacity(capacity, policy);
+    }
+
+    // Allocates the QUEUED messages of the type from the cycle arena of the posting thread - the memory is reused once
+    // the messages are dispatched. Must be called while no messages of the type are queued.
+    template <typename MessageType>
+    void SetQueuedAllocation(const QueuedAllocation allocation)
+    {
+        GetChannel<MessageType>().SetQueuedAllocation(allocation);
+    }
+
+    // Stages the QUEUED messages of the type in a buffer per posting thread, so that the posting threads do not contend.
+    // The messages of one thread are dispatched in the posting order, the messages of different threads are not ordered.
+    // Must be called while no messages of the type are queued.
+    template <typename MessageType>
+    void SetQueuedProducerBuffering(const bool enabled)
+    {
+        GetChannel<MessageType>().SetQueuedProducerBuffering(enabled);
+    }
+
+    // The cycle arenas are shared by all the buses.
+    static AllocatorStats GetCycleArenaStats()
+    {
+        return detail::CycleArena::GetStats();
+    }
+
+    // Coalesces QUEUED messages of the type with the same key (from keyFunction), only the latest one is dispatched.
+    // nullptr turns the coalescing off (default). Must be called while no messages of the type are queued.
+    template <typename MessageType>
+    void SetQueuedCoalescing(const typename detail::EventChannelQueue<MessageType>::KeyFunction keyFunction)
+    {
+        GetChannel<MessageType>().SetQueuedCoalescing(keyFunction);
+    }
+
+    // Chooses how ASYNC messages of the type are delivered:
+    //  - ORDERED - one after another in the posting order (default)
+    //  - ORDERED_PER_KEY - messages with the same key (from keyFunction) in the posting order, different keys in parallel
+    //  - PARALLEL - in parallel without any ordering, handlers have to be thread-safe
+    // At most laneCount messages are handled in parallel, 0 means the async worker count.
+    // Must be called while no ASYNC messages of the type are pending.
+    template <typename MessageType>
+    void SetAsyncPolicy(const AsyncPolicy policy, const size_t laneCount = 0, const typename detail::EventChannelQueue<MessageType>::KeyFunction keyFunction = nullptr)
+    {
+        GetChannel<MessageType>().SetAsyncPolicy(policy, laneCount, keyFunction);
+    }
+
+    // Opt-in parallel DispatchAllQueued - the queued messages of different types are dispatched concurrently
+    // on the async workers, the caller waits until all of them are handled.
+    void SetParallelQueuedDispatch(const bool enabled)
+    {
+        m_manager.SetParallelQueuedDispatch(enabled);
+    }
+
+    // Keeps the queued messages of the type dispatched on the thread calling DispatchAllQueued.
+    template <typename MessageType>
+    void SetQueuedDispatchOnCallerThread(const bool onCallerThread)
+    {
+        GetChannel<MessageType>().SetQueuedDispatchOnCallerThread(onCallerThread);
+    }
+
+    // Opt-in serialization of the handler calls of the type, SYNC, QUEUED and ASYNC dispatches of the type
+    // then never run concurrently, for handlers which are not thread-safe.
+    template <typename MessageType>
+    void SetSerializedDispatch(const bool serialized)
+    {
+        GetChannel<MessageType>().SetSerializedDispatch(serialized);
+    }
+
+    // Lets the observer see every message of the type posted to the bus, see EventChannelQueue::SetPostObserver.
+    template <typename MessageType>
+    void SetPostObserver(detail::IPostObserver<MessageType>* observer)
+    {
+        GetChannel<MessageType>().SetPostObserver(observer);
+    }
+
+    // Counters of all the channels of the bus created so far.
+    std::vector<ChannelMetrics> GetMetrics()
+    {
+        return m_manager.GetMetrics();
+    }
+
+    // Must be called before the first ASYNC post.
+    void SetAsyncWorkerCount(const size_t workerCount)
+    {
+        m_manager.GetExecutor().SetWorkerCount(workerCount);
+    }
+
+private:
+    struct DefaultTag {
+    };
+
+private:
+    explicit EventBus(DefaultTag)
+        : m_manager{ detail::EventChannelQueueManager::Instance() }
+        , m_isDefault{ true }
+    {
+    }
+
+    template <typename MessageType>
+    detail::EventChannelQueue<MessageType>& GetChannel()
+    {
+        using ChannelType = detail::EventChannelQueue<MessageType>;
+
+        if (m_isDefault) {
+            return ChannelType::Instance();
+        }
+
+        return m_channels.Get<ChannelType>(detail::GetTypeIndex<MessageType>(), [this]() { return new ChannelType(m_manager); });
+    }
+
+private:
+    EventBus(const EventBus& other) = delete;
+
+    EventBus& operator=(const EventBus& other) = delete;
+
+    EventBus(EventBus&& other) = delete;
+
+    EventBus& operator=(EventBus&& other) = delete;
+
+private:
+    std::unique_ptr<detail::EventChannelQueueManager> m_ownedManager;
+
+    detail::EventChannelQueueManager& m_manager;
+
+    const bool m_isDefault;
+
+    // declared after the manager, so the channels are removed from it first
+    detail::ChannelRegistry m_channels;
+};
+} // namespace worm
+
+#endif
@@ -1,58 +1,192 @@
 #ifndef __WH_EVENT_CHANNEL_H__
 #define __WH_EVENT_CHANNEL_H__
 
-#include "detail/EventChannelQueue.h"
+#include "EventBus.h"
 
-namespace worm {
-enum class DispatchType {
-    SYNC,
-    ASYNC,
-    QUEUED
-};
+#include <chrono>
+#include <vector>
 
+namespace worm {
+// Static API of the default event bus, see EventBus for the details.
 class EventChannel final {
 public:
     template <typename MessageType, typename EventHandlerType>
-    static void Add(EventHandlerType& handler)
+    static SubscriptionToken Add(EventHandlerType& handler)
+    {
+        return EventBus::GetDefault().Add<MessageType>(handler);
+    }
+
+    template <typename MessageType, typename EventHandlerType>
+    static SubscriptionToken Add(EventHandlerType& handler, const size_t routingKey)
+    {
+        return EventBus::GetDefault().Add<MessageType>(handler, routingKey);
+    }
+
+    template <typename MessageType>
+    static void SetRoutingKeyFunction(const typename detail::EventChannelQueue<MessageType>::KeyFunction keyFunction)
+    {
+        EventBus::GetDefault().SetRoutingKeyFunction<MessageType>(keyFunction);
+    }
+
+    template <typename MessageType>
+    static void Remove(const SubscriptionToken token)
     {
-        detail::EventChannelQueue<MessageType>::Instance().Add(handler);
+        EventBus::GetDefault().Remove<MessageType>(token);
     }
 
     template <typename MessageType, typename EventHandlerType>
     static void Remove(EventHandlerType& handler)
     {
-        detail::EventChannelQueue<MessageType>::Instance().Remove(handler);
+        EventBus::GetDefault().Remove<MessageType>(handler);
     }
 
     template <typename MessageType>
-    static void Post(const MessageType& message, const DispatchType dispatchType = DispatchType::SYNC)
+    static bool Post(const MessageType& message, const DispatchType dispatchType = DispatchType::SYNC, const Priority priority = Priority::NORMAL)
+    {
+        return EventBus::GetDefault().Post(message, dispatchType, priority);
+    }
+
+    template <typename MessageType, typename = std::enable_if_t<!std::is_reference_v<MessageType>>>
+    static bool Post(MessageType&& message, const DispatchType dispatchType = DispatchType::SYNC, const Priority priority = Priority::NORMAL)
+    {
+        return EventBus::GetDefault().Post(std::move(message), dispatchType, priority);
+    }
+
+    template <typename MessageType, typename... Args>
+    static bool Emplace(const DispatchType dispatchType, Args&&... args)
+    {
+        return EventBus::GetDefault().Emplace<MessageType>(dispatchType, std::forward<Args>(args)...);
+    }
+
+    template <typename MessageType, typename IteratorType>
+    static size_t PostBatch(IteratorType first, IteratorType last, const DispatchType dispatchType = DispatchType::SYNC, const Priority priority = Priority::NORMAL)
     {
-        switch (dispatchType) {
-        case DispatchType::ASYNC:
-            detail::EventChannelQueue<MessageType>::Instance().PostAsync(message);
-            break;
-        case DispatchType::QUEUED:
-            detail::EventChannelQueue<MessageType>::Instance().PostQueued(message);
-            break;
-        default:
-            detail::EventChannelQueue<MessageType>::Instance().Post(message);
-            break;
-        }
+        return EventBus::GetDefault().PostBatch<MessageType>(first, last, dispatchType, priority);
+    }
+
+    template <typename MessageType>
+    static TimerToken PostDelayed(MessageType message, const std::chrono::steady_clock::duration delay, const DispatchType dispatchType = DispatchType::QUEUED, const Priority priority = Priority::NORMAL)
+    {
+        return EventBus::GetDefault().PostDelayed(std::move(message), delay, dispatchType, priority);
+    }
+
+    template <typename MessageType>
+    static TimerToken PostAt(MessageType message, const std::chrono::steady_clock::time_point deadline, const DispatchType dispatchType = DispatchType::QUEUED, const Priority priority = Priority::NORMAL)
+    {
+        return EventBus::GetDefault().PostAt(std::move(message), deadline, dispatchType, priority);
+    }
+
+    template <typename MessageType>
+    static bool CancelTimer(const TimerToken token)
+    {
+        return EventBus::GetDefault().CancelTimer<MessageType>(token);
+    }
+
+    static void AdvanceTimers()
+    {
+        EventBus::GetDefault().AdvanceTimers();
     }
 
     static void DispatchAllQueued()
     {
-        detail::EventChannelQueueManager::Instance().DispatchAllQueued();
+        EventBus::GetDefault().DispatchAllQueued();
+    }
+
+    static size_t DispatchAllQueued(const DispatchBudget& budget)
+    {
+        return EventBus::GetDefault().DispatchAllQueued(budget);
+    }
+
+    static uint64_t GetQueuedBacklog()
+    {
+        return EventBus::GetDefault().GetQueuedBacklog();
     }
 
     static void DispatchAllAsync()
     {
-        detail::EventChannelQueueManager::Instance().DispatchAllAsync();
+        EventBus::GetDefault().DispatchAllAsync();
+    }
+
+    static bool PollAsync()
+    {
+        return EventBus::GetDefault().PollAsync();
+    }
+
+    static bool WaitAsync(const std::chrono::steady_clock::duration timeout)
+    {
+        return EventBus::GetDefault().WaitAsync(timeout);
+    }
+
+    static uint64_t GetPendingAsyncCount()
+    {
+        return EventBus::GetDefault().GetPendingAsyncCount();
     }
 
     static void DispatchAll()
     {
-        detail::EventChannelQueueManager::Instance().DispatchAll();
+        EventBus::GetDefault().DispatchAll();
+    }
+
+    template <typename MessageType>
+    static void SetQueuedCapacity(const size_t capacity, const OverflowPolicy policy = OverflowPolicy::BLOCK)
+    {
+        EventBus::GetDefault().SetQueuedCapacity<MessageType>(capacity, policy);
+    }
+
+    template <typename MessageType>
+    static void SetQueuedAllocation(const QueuedAllocation allocation)
+    {
+        EventBus::GetDefault().SetQueuedAllocation<MessageType>(allocation);
+    }
+
+    template <typename MessageType>
+    static void SetQueuedProducerBuffering(const bool enabled)
+    {
+        EventBus::GetDefault().SetQueuedProducerBuffering<MessageType>(enabled);
+    }
+
+    static AllocatorStats GetCycleArenaStats()
+    {
+        return EventBus::GetCycleArenaStats();
+    }
+
+    template <typename MessageType>
+    static void SetQueuedCoalescing(const typename detail::EventChannelQueue<MessageType>::KeyFunction keyFunction)
+    {
+        EventBus::GetDefault().SetQueuedCoalescing<MessageType>(keyFunction);
+    }
+
+    template <typename MessageType>
+    static void SetAsyncPolicy(const AsyncPolicy policy, const size_t laneCount = 0, const typename detail::EventChannelQueue<MessageType>::KeyFunction keyFunction = nullptr)
+    {
+        EventBus::GetDefault().SetAsyncPolicy<MessageType>(policy, laneCount, keyFunction);
+    }
+
+    static void SetParallelQueuedDispatch(const bool enabled)
+    {
+        EventBus::GetDefault().SetParallelQueuedDispatch(enabled);
+    }
+
+    template <typename MessageType>
+    static void SetQueuedDispatchOnCallerThread(const bool onCallerThread)
+    {
+        EventBus::GetDefault().SetQueuedDispatchOnCallerThread<MessageType>(onCallerThread);
+    }
+
+    template <typename MessageType>
+    static void SetSerializedDispatch(const bool serialized)
+    {
+        EventBus::GetDefault().SetSerializedDispatch<MessageType>(serialized);
+    }
+
+    static std::vector<ChannelMetrics> GetMetrics()
+    {
+        return EventBus::GetDefault().GetMetrics();
+    }
+
+    static void SetAsyncWorkerCount(const size_t workerCount)
+    {
+        EventBus::GetDefault().SetAsyncWorkerCount(workerCount);
     }
 
 private:
@@ -71,4 +205,4 @@ private:
 };
 } // namespace worm
 
-#endif
\ No newline at end of file
+#endif
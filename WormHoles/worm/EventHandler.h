@@ -8,14 +8,32 @@ template <typename EventHandlerType, typename EventType>
 class EventHandler final {
 public:
     EventHandler(EventHandlerType& instance)
-        : m_handlerInstance{ instance }
+        : EventHandler(EventBus::GetDefault(), instance)
+    {
+    }
+
+    EventHandler(EventHandlerType& instance, const size_t routingKey)
+        : EventHandler(EventBus::GetDefault(), instance, routingKey)
+    {
+    }
+
+    EventHandler(EventBus& bus, EventHandlerType& instance)
+        : m_bus{ bus }
+        , m_handlerInstance{ instance }
+        , m_subscription{ bus.Add<EventType>(*this) }
+    {
+    }
+
+    EventHandler(EventBus& bus, EventHandlerType& instance, const size_t routingKey)
+        : m_bus{ bus }
+        , m_handlerInstance{ instance }
+        , m_subscription{ bus.Add<EventType>(*this, routingKey) }
     {
-        EventChannel::Add<EventType>(*this);
     }
 
     ~EventHandler()
     {
-        EventChannel::Remove<EventType>(*this);
+        m_bus.Remove<EventType>(m_subscription);
     }
 
 public:
@@ -34,7 +52,11 @@ public:
     }
 
 private:
+    EventBus& m_bus;
+
     EventHandlerType& m_handlerInstance;
+
+    SubscriptionToken m_subscription;
 };
 } // namespace worm
 
@@ -0,0 +1,228 @@
+#ifndef __WH_EVENT_RECORDER_H__
+#define __WH_EVENT_RECORDER_H__
+
+#include "EventBus.h"
+#include "detail/EventLog.h"
+
+#if WH_HAS_MAPPED_FILES
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace worm {
+enum class ReplayTiming {
+    FULL_SPEED,
+    ORIGINAL
+};
+
+// Records the messages of chosen trivially copyable types posted to a bus into a memory-mapped event log.
+// The messages are recorded when they are posted, also the ones a full or coalescing queue drops later. Every record
+// holds the type tag passed to Record, the time since the recorder was created and the dispatch type and priority
+// of the post. The log has a fixed capacity, the messages which do not fit are dropped and counted.
+// A recorded type can not be recorded by another recorder at the same time. The recorder has to be destroyed while
+// no messages of the recorded types are posted.
+class EventRecorder final {
+public:
+    static const inline size_t DEFAULT_CAPACITY{ 64 * 1024 * 1024 };
+
+public:
+    explicit EventRecorder(const std::string& path, const size_t capacity = DEFAULT_CAPACITY)
+        : EventRecorder(EventBus::GetDefault(), path, capacity)
+    {
+    }
+
+    EventRecorder(EventBus& bus, const std::string& path, const size_t capacity = DEFAULT_CAPACITY)
+        : m_bus{ bus }
+        , m_log{ path, capacity }
+        , m_start{ std::chrono::steady_clock::now() }
+    {
+    }
+
+    ~EventRecorder() = default;
+
+public:
+    template <typename MessageType>
+    void Record(const uint32_t typeTag)
+    {
+        static_assert(std::is_trivially_copyable_v<MessageType>, "Only trivially copyable messages can be recorded");
+
+        m_channels.push_back(std::make_unique<RecordedChannel<MessageType>>(*this, typeTag));
+    }
+
+    uint64_t GetRecordCount() const
+    {
+        return m_log.GetRecordCount();
+    }
+
+    uint64_t GetDroppedCount() const
+    {
+        return m_log.GetDroppedCount();
+    }
+
+private:
+    struct IRecordedChannel {
+        virtual ~IRecordedChannel() = default;
+    };
+
+    template <typename MessageType>
+    class RecordedChannel final : public IRecordedChannel, public detail::IPostObserver<MessageType> {
+    public:
+        RecordedChannel(EventRecorder& recorder, const uint32_t typeTag)
+            : m_recorder{ recorder }
+            , m_typeTag{ typeTag }
+        {
+            m_recorder.m_bus.SetPostObserver<MessageType>(this);
+        }
+
+        ~RecordedChannel() override
+        {
+            m_recorder.m_bus.SetPostObserver<MessageType>(nullptr);
+        }
+
+    public:
+        void OnPosted(const MessageType& message, const DispatchType dispatchType, const Priority priority) override
+        {
+            const auto timestamp{ std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_recorder.m_start).count() };
+            m_recorder.m_log.Append(m_typeTag, static_cast<uint64_t>(timestamp), &message, sizeof(MessageType), EncodePost(dispatchType, priority));
+        }
+
+    private:
+        EventRecorder& m_recorder;
+
+        const uint32_t m_typeTag;
+    };
+
+    // dispatch type in the low byte, priority in the next one
+    static uint32_t EncodePost(const DispatchType dispatchType, const Priority priority)
+    {
+        return static_cast<uint32_t>(dispatchType) | static_cast<uint32_t>(priority) << 8;
+    }
+
+    static DispatchType DecodeDispatchType(const uint32_t flags)
+    {
+        return static_cast<DispatchType>(flags & 0xFF);
+    }
+
+    static Priority DecodePriority(const uint32_t flags)
+    {
+        return static_cast<Priority>((flags >> 8) & 0xFF);
+    }
+
+private:
+    friend class EventReplayer;
+
+private:
+    EventRecorder(const EventRecorder& other) = delete;
+
+    EventRecorder& operator=(const EventRecorder& other) = delete;
+
+    EventRecorder(EventRecorder&& other) = delete;
+
+    EventRecorder& operator=(EventRecorder&& other) = delete;
+
+private:
+    EventBus& m_bus;
+
+    detail::EventLogWriter m_log;
+
+    const std::chrono::steady_clock::time_point m_start;
+
+    // declared after the log, so the handlers are removed before the log is closed
+    std::vector<std::unique_ptr<IRecordedChannel>> m_channels;
+};
+
+// Posts the records of an event log back to a bus in the recorded order - at full speed or at the recorded timing,
+// with the recorded dispatch type and priority. Records of types which are not registered are skipped.
+class EventReplayer final {
+public:
+    explicit EventReplayer(const std::string& path)
+        : EventReplayer(EventBus::GetDefault(), path)
+    {
+    }
+
+    EventReplayer(EventBus& bus, const std::string& path)
+        : m_bus{ bus }
+        , m_log{ path }
+    {
+    }
+
+    ~EventReplayer() = default;
+
+public:
+    // The dispatch type overrides the recorded one if set.
+    template <typename MessageType>
+    void Register(const uint32_t typeTag, const std::optional<DispatchType> dispatchType = std::nullopt)
+    {
+        static_assert(std::is_trivially_copyable_v<MessageType>, "Only trivially copyable messages can be replayed");
+
+        m_types[typeTag] = { sizeof(MessageType), [this, dispatchType](const unsigned char* payload, const uint32_t flags) {
+                                std::aligned_storage_t<sizeof(MessageType), alignof(MessageType)> storage;
+                                std::memcpy(&storage, payload, sizeof(MessageType));
+                                m_bus.Post(*std::launder(reinterpret_cast<const MessageType*>(&storage)), dispatchType.value_or(EventRecorder::DecodeDispatchType(flags)), EventRecorder::DecodePriority(flags));
+                            } };
+    }
+
+    // Returns the number of posted messages, throws if a record does not match the size of its registered type.
+    size_t Replay(const ReplayTiming timing = ReplayTiming::FULL_SPEED)
+    {
+        const auto start{ std::chrono::steady_clock::now() };
+
+        size_t count{ 0 };
+        m_log.ForEach([&](const detail::EventLogReader::Record& record) {
+            const auto it{ m_types.find(record.typeTag) };
+            if (it == m_types.end()) {
+                return;
+            }
+
+            if (record.payloadSize != it->second.size) {
+                throw std::runtime_error("Recorded message size does not match the registered type");
+            }
+
+            if (timing == ReplayTiming::ORIGINAL) {
+                std::this_thread::sleep_until(start + std::chrono::nanoseconds{ record.timestamp });
+            }
+
+            it->second.post(record.payload, record.flags);
+            ++count;
+        });
+        return count;
+    }
+
+private:
+    struct ReplayedType {
+        size_t size;
+
+        std::function<void(const unsigned char*, uint32_t)> post;
+    };
+
+private:
+    EventReplayer(const EventReplayer& other) = delete;
+
+    EventReplayer& operator=(const EventReplayer& other) = delete;
+
+    EventReplayer(EventReplayer&& other) = delete;
+
+    EventReplayer& operator=(EventReplayer&& other) = delete;
+
+private:
+    EventBus& m_bus;
+
+    detail::EventLogReader m_log;
+
+    std::unordered_map<uint32_t, ReplayedType> m_types;
+};
+} // namespace worm
+
+#endif
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef __WH_SHARED_MEMORY_TRANSPORT_H__
+#define __WH_SHARED_MEMORY_TRANSPORT_H__
+
+#include "EventBus.h"
+#include "detail/SharedMemoryRing.h"
+
+#if WH_HAS_SHARED_MEMORY
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace worm {
+// Receives the messages of a trivially copyable type published by other processes into the named shared memory ring
+// and dispatches them to the handlers of a bus. Creates the ring, so it has to be constructed before the publishers.
+template <typename MessageType>
+class SharedMemorySubscriber final {
+public:
+    SharedMemorySubscriber(const std::string& name, const size_t capacity)
+        : SharedMemorySubscriber(EventBus::GetDefault(), name, capacity)
+    {
+    }
+
+    // The capacity must be a power of two.
+    SharedMemorySubscriber(EventBus& bus, const std::string& name, const size_t capacity)
+        : m_bus{ bus }
+        , m_ring{ name, capacity }
+    {
+    }
+
+    ~SharedMemorySubscriber() = default;
+
+public:
+    // Dispatches the messages published so far on the calling thread, the handlers read the messages directly
+    // from the shared memory. Returns the number of dispatched messages.
+    size_t Dispatch()
+    {
+        return m_ring.ConsumeAll([this](const MessageType& message) { m_bus.Post(message, DispatchType::SYNC); });
+    }
+
+private:
+    SharedMemorySubscriber(const SharedMemorySubscriber& other) = delete;
+
+    SharedMemorySubscriber& operator=(const SharedMemorySubscriber& other) = delete;
+
+    SharedMemorySubscriber(SharedMemorySubscriber&& other) = delete;
+
+    SharedMemorySubscriber& operator=(SharedMemorySubscriber&& other) = delete;
+
+private:
+    EventBus& m_bus;
+
+    detail::SharedMemoryRing<MessageType> m_ring;
+};
+
+// Mirrors the messages of a trivially copyable type handled on a bus into the named shared memory ring of
+// a SharedMemorySubscriber in another process. Any number of publishers may share one ring.
+// With the BLOCK policy a full ring stalls the posting thread until the subscriber catches up, with DROP_NEWEST
+// the message is dropped and counted.
+template <typename MessageType>
+class SharedMemoryPublisher final {
+public:
+    explicit SharedMemoryPublisher(const std::string& name, const OverflowPolicy policy = OverflowPolicy::BLOCK)
+        : SharedMemoryPublisher(EventBus::GetDefault(), name, policy)
+    {
+    }
+
+    SharedMemoryPublisher(EventBus& bus, const std::string& name, const OverflowPolicy policy = OverflowPolicy::BLOCK)
+        : m_bus{ bus }
+        , m_ring{ name }
+        , m_policy{ CheckPolicy(policy) }
+        , m_subscription{ bus.Add<MessageType>(*this) }
+    {
+    }
+
+    ~SharedMemoryPublisher()
+    {
+        m_bus.Remove<MessageType>(m_subscription);
+    }
+
+public:
+    void operator()(const MessageType& message)
+    {
+        while (!m_ring.TryPush(message)) {
+            if (m_policy != OverflowPolicy::BLOCK) {
+                m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    uint64_t GetDroppedCount() const
+    {
+        return m_droppedCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    static OverflowPolicy CheckPolicy(const OverflowPolicy policy)
+    {
+        if (policy != OverflowPolicy::BLOCK && policy != OverflowPolicy::DROP_NEWEST) {
+            throw std::runtime_error("SharedMemoryPublisher supports only the BLOCK and DROP_NEWEST policies");
+        }
+        return policy;
+    }
+
+private:
+    SharedMemoryPublisher(const SharedMemoryPublisher& other) = delete;
+
+    SharedMemoryPublisher& operator=(const SharedMemoryPublisher& other) = delete;
+
+    SharedMemoryPublisher(SharedMemoryPublisher&& other) = delete;
+
+    SharedMemoryPublisher& operator=(SharedMemoryPublisher&& other) = delete;
+
+private:
+    EventBus& m_bus;
+
+    detail::SharedMemoryRing<MessageType> m_ring;
+
+    const OverflowPolicy m_policy;
+
+    std::atomic<uint64_t> m_droppedCount{ 0 };
+
+    SubscriptionToken m_subscription;
+};
+} // namespace worm
+
+#endif
+
+#endif
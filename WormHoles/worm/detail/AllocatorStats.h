@@ -0,0 +1,25 @@
+#ifndef __WH_ALLOCATOR_STATS_H__
+#define __WH_ALLOCATOR_STATS_H__
+
+#include <cstdint>
+
+namespace worm::detail {
+struct AllocatorStats {
+    // memory currently held by the allocator
+    uint64_t reservedBytes{ 0 };
+
+    // allocations served from the reserved memory
+    uint64_t allocationCount{ 0 };
+
+    // allocations too big for the allocator, served by the heap
+    uint64_t heapFallbackCount{ 0 };
+
+    // regions requested from the heap
+    uint64_t blockAllocationCount{ 0 };
+
+    // arena rewinds once everything allocated from a region has been released
+    uint64_t resetCount{ 0 };
+};
+} // namespace worm::detail
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef __WH_BOUNDED_QUEUE_H__
+#define __WH_BOUNDED_QUEUE_H__
+
+#include "Construct.h"
+#include "RingBuffer.h"
+
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+
+namespace worm::detail {
+enum class OverflowPolicy {
+    BLOCK,
+    DROP_NEWEST,
+    DROP_OLDEST,
+    FAIL
+};
+
+enum class PushResult {
+    PUSHED,
+    DROPPED_NEWEST,
+    DROPPED_OLDEST,
+    REJECTED
+};
+
+// Multi-producer/single-consumer queue with a fixed capacity preallocated up front (twice - the pending items
+// are double-buffered, so the capacity limits the items waiting for the consumer).
+// A BLOCK-ing producer waits for the consumer, so it must not be the thread consuming the queue.
+template <typename ItemType>
+class BoundedQueue final {
+public:
+    BoundedQueue(const size_t capacity, const OverflowPolicy policy)
+        : m_items(capacity)
+        , m_drainedItems(capacity)
+        , m_policy{ policy }
+    {
+        if (capacity == 0) {
+            throw std::runtime_error("BoundedQueue capacity must be greater than zero");
+        }
+    }
+
+    ~BoundedQueue() = default;
+
+public:
+    template <typename... Args>
+    PushResult Emplace(Args&&... args)
+    {
+        auto result{ PushResult::PUSHED };
+        {
+            std::unique_lock lock{ m_mutex };
+
+            if (m_items.IsFull()) {
+                switch (m_policy) {
+                case OverflowPolicy::BLOCK:
+                    m_notFullCondition.wait(lock, [this]() { return !m_items.IsFull(); });
+                    break;
+                case OverflowPolicy::DROP_NEWEST:
+                    return PushResult::DROPPED_NEWEST;
+                case OverflowPolicy::DROP_OLDEST:
+                    m_items.Front().reset();
+                    m_items.PopFront();
+                    result = PushResult::DROPPED_OLDEST;
+                    break;
+                default:
+                    return PushResult::REJECTED;
+                }
+            }
+
+            m_items.PeekTail().emplace(Construct<ItemType>(std::forward<Args>(args)...));
+            m_items.CommitTail();
+        }
+        return result;
+    }
+
+    // Consumes items pushed before the call, items pushed concurrently are left for the next call.
+    // The pending items are swapped out in O(1) and consumed without holding the lock, producers meanwhile
+    // fill the other buffer. Only one thread may consume at a time.
+    template <typename ConsumerType>
+    size_t ConsumeAll(ConsumerType&& consumer)
+    {
+        return Consume(std::numeric_limits<size_t>::max(), consumer);
+    }
+
+    // Consumes at most maxCount items, the swapped out items which are left wait for the next call and do not
+    // count against the capacity.
+    template <typename ConsumerType>
+    size_t Consume(const size_t maxCount, ConsumerType&& consumer)
+    {
+        // leftovers are older than anything pushed since
+        auto count{ ConsumeDrainedItems(maxCount, consumer) };
+        if (count == maxCount || !m_drainedItems.IsEmpty()) {
+            return count;
+        }
+
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            if (m_items.IsEmpty()) {
+                return count;
+            }
+            std::swap(m_items, m_drainedItems);
+        }
+
+        m_notFullCondition.notify_all();
+
+        return count + ConsumeDrainedItems(maxCount - count, consumer);
+    }
+
+    // Must not be called concurrently with ConsumeAll.
+    bool IsEmpty() const
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        return m_items.IsEmpty() && m_drainedItems.IsEmpty();
+    }
+
+    size_t GetCapacity() const
+    {
+        return m_items.Capacity();
+    }
+
+private:
+    template <typename ConsumerType>
+    size_t ConsumeDrainedItems(const size_t maxCount, ConsumerType& consumer)
+    {
+        size_t count{ 0 };
+        while (count < maxCount && !m_drainedItems.IsEmpty()) {
+            auto& slot{ m_drainedItems.Front() };
+            try {
+                consumer(*slot);
+            } catch (...) {
+                slot.reset();
+                m_drainedItems.PopFront();
+                throw;
+            }
+            slot.reset();
+            m_drainedItems.PopFront();
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    BoundedQueue(const BoundedQueue& other) = delete;
+
+    BoundedQueue& operator=(const BoundedQueue& other) = delete;
+
+    BoundedQueue(BoundedQueue&& other) = delete;
+
+    BoundedQueue& operator=(BoundedQueue&& other) = delete;
+
+private:
+    mutable std::mutex m_mutex;
+
+    std::condition_variable m_notFullCondition;
+
+    RingBuffer<std::optional<ItemType>, 0> m_items;
+
+    // owned by the consumer, swapped with m_items once it is consumed
+    RingBuffer<std::optional<ItemType>, 0> m_drainedItems;
+
+    const OverflowPolicy m_policy;
+};
+} // namespace worm::detail
+
+#endif
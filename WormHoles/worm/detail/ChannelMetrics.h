@@ -0,0 +1,259 @@
+#ifndef __WH_CHANNEL_METRICS_H__
+#define __WH_CHANNEL_METRICS_H__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <typeinfo>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace worm::detail {
+struct ChannelMetricsSnapshot {
+    static const inline size_t LATENCY_BUCKET_COUNT{ 32 };
+
+    std::string eventTypeName;
+
+    uint64_t postedCount{ 0 };
+
+    uint64_t dispatchedCount{ 0 };
+
+    uint64_t droppedCount{ 0 };
+
+    // QUEUED events replaced by a newer one with the same key before the dispatch
+    uint64_t coalescedCount{ 0 };
+
+    // events waiting for DispatchAllQueued
+    uint64_t queuedCount{ 0 };
+
+    // ASYNC and ASYNC_DETACHED events not handled yet
+    uint64_t asyncInFlightCount{ 0 };
+
+    // Bucket i counts sampled dispatches which took [2^(i - 1), 2^i) nanoseconds, the last bucket counts also
+    // the longer ones. Every LATENCY_SAMPLE_INTERVAL-th dispatch of a shard is sampled.
+    std::array<uint64_t, LATENCY_BUCKET_COUNT> dispatchLatencyHistogram{};
+};
+
+// Channel counters sharded per thread, updated with relaxed atomics only.
+class ChannelMetrics final {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // queued events are counted per priority lane
+    static const inline size_t QUEUED_LANE_COUNT{ 4 };
+
+    // the clock is read only for the sampled dispatches, the counters are always on
+    static const inline uint64_t LATENCY_SAMPLE_INTERVAL{ 64 };
+
+    class DispatchScope final {
+    public:
+        explicit DispatchScope(ChannelMetrics& metrics)
+            : m_metrics{ metrics }
+            , m_isSampled{ metrics.OnDispatched() }
+            , m_start{ m_isSampled ? Clock::now() : Clock::time_point{} }
+        {
+        }
+
+        ~DispatchScope()
+        {
+            if (m_isSampled) {
+                m_metrics.OnLatencySampled(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_start).count());
+            }
+        }
+
+    private:
+        DispatchScope(const DispatchScope& other) = delete;
+
+        DispatchScope& operator=(const DispatchScope& other) = delete;
+
+        DispatchScope(DispatchScope&& other) = delete;
+
+        DispatchScope& operator=(DispatchScope&& other) = delete;
+
+    private:
+        ChannelMetrics& m_metrics;
+
+        const bool m_isSampled;
+
+        const Clock::time_point m_start;
+    };
+
+public:
+    ChannelMetrics() = default;
+
+    ~ChannelMetrics() = default;
+
+public:
+    void OnPosted(const uint64_t count = 1)
+    {
+        GetShard().posted.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void OnDropped(const uint64_t count = 1)
+    {
+        GetShard().dropped.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void OnCoalesced(const uint64_t count = 1)
+    {
+        GetShard().coalesced.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void OnQueued(const size_t lane, const uint64_t count = 1)
+    {
+        GetShard().queued[lane].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void OnDequeued(const size_t lane, const uint64_t count = 1)
+    {
+        GetShard().dequeued[lane].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void OnAsyncScheduled(const uint64_t count = 1)
+    {
+        GetShard().asyncScheduled.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void OnAsyncCompleted(const uint64_t count = 1)
+    {
+        GetShard().asyncCompleted.fetch_add(count, std::memory_order_relaxed);
+    }
+
+    // Returns true if the latency of the dispatch should be sampled.
+    bool OnDispatched()
+    {
+        return GetShard().dispatched.fetch_add(1, std::memory_order_relaxed) % LATENCY_SAMPLE_INTERVAL == 0;
+    }
+
+    void OnLatencySampled(const int64_t latencyNs)
+    {
+        GetShard().dispatchLatencyHistogram[GetLatencyBucket(latencyNs)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t GetQueuedCount() const
+    {
+        uint64_t count{ 0 };
+        for (size_t lane = 0; lane < QUEUED_LANE_COUNT; ++lane) {
+            count += GetQueuedCount(lane);
+        }
+        return count;
+    }
+
+    uint64_t GetQueuedCount(const size_t lane) const
+    {
+        uint64_t queued{ 0 };
+        uint64_t dequeued{ 0 };
+        for (const auto& shard : m_shards) {
+            queued += shard.queued[lane].load(std::memory_order_relaxed);
+            dequeued += shard.dequeued[lane].load(std::memory_order_relaxed);
+        }
+        return queued > dequeued ? queued - dequeued : 0;
+    }
+
+    uint64_t GetAsyncInFlightCount() const
+    {
+        uint64_t asyncScheduled{ 0 };
+        uint64_t asyncCompleted{ 0 };
+        for (const auto& shard : m_shards) {
+            asyncScheduled += shard.asyncScheduled.load(std::memory_order_relaxed);
+            asyncCompleted += shard.asyncCompleted.load(std::memory_order_relaxed);
+        }
+        return asyncScheduled > asyncCompleted ? asyncScheduled - asyncCompleted : 0;
+    }
+
+    // The counters are summed without stopping the writers, so the snapshot is not an atomic cut.
+    void Collect(ChannelMetricsSnapshot& snapshot) const
+    {
+        uint64_t asyncScheduled{ 0 };
+        uint64_t asyncCompleted{ 0 };
+        for (const auto& shard : m_shards) {
+            snapshot.postedCount += shard.posted.load(std::memory_order_relaxed);
+            snapshot.dispatchedCount += shard.dispatched.load(std::memory_order_relaxed);
+            snapshot.droppedCount += shard.dropped.load(std::memory_order_relaxed);
+            snapshot.coalescedCount += shard.coalesced.load(std::memory_order_relaxed);
+            asyncScheduled += shard.asyncScheduled.load(std::memory_order_relaxed);
+            asyncCompleted += shard.asyncCompleted.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < ChannelMetricsSnapshot::LATENCY_BUCKET_COUNT; ++i) {
+                snapshot.dispatchLatencyHistogram[i] += shard.dispatchLatencyHistogram[i].load(std::memory_order_relaxed);
+            }
+        }
+        snapshot.queuedCount = GetQueuedCount();
+        snapshot.asyncInFlightCount = asyncScheduled > asyncCompleted ? asyncScheduled - asyncCompleted : 0;
+    }
+
+private:
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> posted{ 0 };
+
+        std::atomic<uint64_t> dispatched{ 0 };
+
+        std::atomic<uint64_t> dropped{ 0 };
+
+        std::atomic<uint64_t> coalesced{ 0 };
+
+        std::atomic<uint64_t> queued[QUEUED_LANE_COUNT]{};
+
+        std::atomic<uint64_t> dequeued[QUEUED_LANE_COUNT]{};
+
+        std::atomic<uint64_t> asyncScheduled{ 0 };
+
+        std::atomic<uint64_t> asyncCompleted{ 0 };
+
+        std::atomic<uint64_t> dispatchLatencyHistogram[ChannelMetricsSnapshot::LATENCY_BUCKET_COUNT]{};
+    };
+
+private:
+    Shard& GetShard()
+    {
+        return m_shards[s_shardIndex];
+    }
+
+    static size_t GetLatencyBucket(const int64_t latencyNs)
+    {
+        size_t bucket{ 0 };
+        for (auto value{ static_cast<uint64_t>(latencyNs > 0 ? latencyNs : 0) }; value != 0 && bucket + 1 < ChannelMetricsSnapshot::LATENCY_BUCKET_COUNT; value >>= 1) {
+            ++bucket;
+        }
+        return bucket;
+    }
+
+private:
+    ChannelMetrics(const ChannelMetrics& other) = delete;
+
+    ChannelMetrics& operator=(const ChannelMetrics& other) = delete;
+
+    ChannelMetrics(ChannelMetrics&& other) = delete;
+
+    ChannelMetrics& operator=(ChannelMetrics&& other) = delete;
+
+private:
+    static const inline size_t SHARD_COUNT{ 8 };
+
+    static inline std::atomic<size_t> s_nextShardIndex{ 0 };
+
+    static inline thread_local const size_t s_shardIndex{ s_nextShardIndex.fetch_add(1, std::memory_order_relaxed) % SHARD_COUNT };
+
+    Shard m_shards[SHARD_COUNT];
+};
+
+template <typename Type>
+std::string GetTypeName()
+{
+#if defined(__GNUG__)
+    int status{ 0 };
+    std::unique_ptr<char, void (*)(void*)> name{ abi::__cxa_demangle(typeid(Type).name(), nullptr, nullptr, &status), std::free };
+    if (status == 0 && name) {
+        return name.get();
+    }
+#endif
+    return typeid(Type).name();
+}
+} // namespace worm::detail
+
+#endif
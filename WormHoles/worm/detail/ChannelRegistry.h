@@ -0,0 +1,116 @@
+#ifndef __WH_CHANNEL_REGISTRY_H__
+#define __WH_CHANNEL_REGISTRY_H__
+
+#include "IEventChannelQueue.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace worm::detail {
+// Process-wide dense index of an event type, used to look up its channel in a registry.
+inline size_t NextTypeIndex()
+{
+    static std::atomic<size_t> nextTypeIndex{ 0 };
+    return nextTypeIndex.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename EventType>
+size_t GetTypeIndex()
+{
+    static const size_t index{ NextTypeIndex() };
+    return index;
+}
+
+// Owns the channels of one event bus. A channel is created on the first lookup of its type, the lookup of an existing
+// channel is lock-free - the channels are kept in blocks of stable slots indexed by the type index.
+class ChannelRegistry final {
+public:
+    ChannelRegistry() = default;
+
+    ~ChannelRegistry()
+    {
+        // newest first, like function-local singletons
+        while (!m_channels.empty()) {
+            m_channels.pop_back();
+        }
+
+        for (auto& block : m_blocks) {
+            delete block.load(std::memory_order_relaxed);
+        }
+    }
+
+public:
+    template <typename ChannelType, typename FactoryType>
+    ChannelType& Get(const size_t typeIndex, FactoryType&& factory)
+    {
+        if (typeIndex < BLOCK_SIZE * MAX_BLOCK_COUNT) {
+            if (const auto block{ m_blocks[typeIndex / BLOCK_SIZE].load(std::memory_order_acquire) }) {
+                if (const auto channel{ block->channels[typeIndex % BLOCK_SIZE].load(std::memory_order_acquire) }) {
+                    return static_cast<ChannelType&>(*channel);
+                }
+            }
+        }
+
+        return Create<ChannelType>(typeIndex, factory);
+    }
+
+private:
+    static const inline size_t BLOCK_SIZE{ 256 };
+
+    static const inline size_t MAX_BLOCK_COUNT{ 64 };
+
+    struct Block {
+        std::atomic<IEventChannelQueue*> channels[BLOCK_SIZE]{};
+    };
+
+private:
+    template <typename ChannelType, typename FactoryType>
+    ChannelType& Create(const size_t typeIndex, FactoryType& factory)
+    {
+        if (typeIndex >= BLOCK_SIZE * MAX_BLOCK_COUNT) {
+            throw std::runtime_error("Too many event types in one event bus.");
+        }
+
+        std::scoped_lock lock{ m_mutex };
+
+        auto& blockSlot{ m_blocks[typeIndex / BLOCK_SIZE] };
+        auto block{ blockSlot.load(std::memory_order_relaxed) };
+        if (!block) {
+            block = new Block{};
+            blockSlot.store(block, std::memory_order_release);
+        }
+
+        auto& channelSlot{ block->channels[typeIndex % BLOCK_SIZE] };
+        if (const auto channel{ channelSlot.load(std::memory_order_relaxed) }) {
+            return static_cast<ChannelType&>(*channel);
+        }
+
+        std::unique_ptr<ChannelType> channel{ factory() };
+        auto& result{ *channel };
+        m_channels.emplace_back(std::move(channel));
+        channelSlot.store(&result, std::memory_order_release);
+        return result;
+    }
+
+private:
+    ChannelRegistry(const ChannelRegistry& other) = delete;
+
+    ChannelRegistry& operator=(const ChannelRegistry& other) = delete;
+
+    ChannelRegistry(ChannelRegistry&& other) = delete;
+
+    ChannelRegistry& operator=(ChannelRegistry&& other) = delete;
+
+private:
+    std::mutex m_mutex;
+
+    std::atomic<Block*> m_blocks[MAX_BLOCK_COUNT]{};
+
+    std::vector<std::unique_ptr<IEventChannelQueue>> m_channels;
+};
+} // namespace worm::detail
+
+#endif
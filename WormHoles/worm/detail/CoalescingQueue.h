@@ -0,0 +1,150 @@
+#ifndef __WH_COALESCING_QUEUE_H__
+#define __WH_COALESCING_QUEUE_H__
+
+#include "Construct.h"
+
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace worm::detail {
+// Multi-producer/single-consumer queue keeping only the latest item per key. An item pushed with a key which is
+// still pending replaces the pending item in place, so it keeps the position of the first one.
+// The pending items are double-buffered and the storage is reused, the key index nodes are recycled as well, so
+// a steady state with no more distinct keys per cycle than before does not allocate.
+template <typename ItemType>
+class CoalescingQueue final {
+public:
+    CoalescingQueue() = default;
+
+    ~CoalescingQueue() = default;
+
+public:
+    // Returns true if a pending item has been replaced.
+    template <typename... Args>
+    bool Emplace(const size_t key, Args&&... args)
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        const auto position{ m_indices.find(key) };
+        if (position == m_indices.end()) {
+            InsertIndex(key, m_items.size());
+            m_items.emplace_back(Construct<ItemType>(std::forward<Args>(args)...));
+            return false;
+        }
+
+        m_items[position->second].emplace(Construct<ItemType>(std::forward<Args>(args)...));
+        return true;
+    }
+
+    // Consumes items pushed before the call, items pushed concurrently are left for the next call.
+    // Only one thread may consume at a time.
+    template <typename ConsumerType>
+    size_t ConsumeAll(ConsumerType&& consumer)
+    {
+        return Consume(std::numeric_limits<size_t>::max(), consumer);
+    }
+
+    // Consumes at most maxCount items. The swapped out items which are left wait for the next call, they are no longer
+    // replaced by newer items with the same key.
+    template <typename ConsumerType>
+    size_t Consume(const size_t maxCount, ConsumerType&& consumer)
+    {
+        // leftovers are older than anything pushed since
+        auto count{ ConsumeDrainedItems(maxCount, consumer) };
+        if (count == maxCount || !m_drainedItems.empty()) {
+            return count;
+        }
+
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            if (m_items.empty()) {
+                return count;
+            }
+            std::swap(m_items, m_drainedItems);
+            ClearIndices();
+        }
+
+        return count + ConsumeDrainedItems(maxCount - count, consumer);
+    }
+
+    // Must not be called concurrently with ConsumeAll.
+    bool IsEmpty() const
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        return m_items.empty() && m_drainedItems.empty();
+    }
+
+private:
+    void InsertIndex(const size_t key, const size_t index)
+    {
+        if (m_freeIndexNodes.empty()) {
+            m_indices.emplace(key, index);
+            return;
+        }
+
+        auto node{ std::move(m_freeIndexNodes.back()) };
+        m_freeIndexNodes.pop_back();
+        node.key() = key;
+        node.mapped() = index;
+        m_indices.insert(std::move(node));
+    }
+
+    // the nodes are kept for the next cycle instead of being freed, the bucket array is kept by the map itself
+    void ClearIndices()
+    {
+        while (!m_indices.empty()) {
+            m_freeIndexNodes.push_back(m_indices.extract(m_indices.begin()));
+        }
+    }
+
+    template <typename ConsumerType>
+    size_t ConsumeDrainedItems(const size_t maxCount, ConsumerType& consumer)
+    {
+        size_t count{ 0 };
+        while (count < maxCount && m_nextDrainedItem < m_drainedItems.size()) {
+            auto& item{ m_drainedItems[m_nextDrainedItem++] };
+            consumer(*item);
+            item.reset();
+            ++count;
+        }
+
+        if (m_nextDrainedItem == m_drainedItems.size()) {
+            m_drainedItems.clear();
+            m_nextDrainedItem = 0;
+        }
+        return count;
+    }
+
+private:
+    CoalescingQueue(const CoalescingQueue& other) = delete;
+
+    CoalescingQueue& operator=(const CoalescingQueue& other) = delete;
+
+    CoalescingQueue(CoalescingQueue&& other) = delete;
+
+    CoalescingQueue& operator=(CoalescingQueue&& other) = delete;
+
+private:
+    mutable std::mutex m_mutex;
+
+    // key -> position in m_items
+    std::unordered_map<size_t, size_t> m_indices;
+
+    std::vector<typename std::unordered_map<size_t, size_t>::node_type> m_freeIndexNodes;
+
+    std::vector<std::optional<ItemType>> m_items;
+
+    // owned by the consumer, swapped with m_items once it is consumed
+    std::vector<std::optional<ItemType>> m_drainedItems;
+
+    size_t m_nextDrainedItem{ 0 };
+};
+} // namespace worm::detail
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef __WH_CONSTRUCT_H__
+#define __WH_CONSTRUCT_H__
+
+#include <type_traits>
+#include <utility>
+
+namespace worm::detail {
+// Constructs an object from the arguments, aggregates (typical events) are brace-initialized.
+// The result is a prvalue so it can be used to construct the object in place without a copy/move.
+template <typename ObjectType, typename... Args>
+ObjectType Construct(Args&&... args)
+{
+    if constexpr (std::is_constructible_v<ObjectType, Args&&...>) {
+        return ObjectType(std::forward<Args>(args)...);
+    } else {
+        return ObjectType{ std::forward<Args>(args)... };
+    }
+}
+} // namespace worm::detail
+
+#endif
@@ -0,0 +1,225 @@
+#ifndef __WH_CYCLE_ARENA_H__
+#define __WH_CYCLE_ARENA_H__
+
+#include "AllocatorStats.h"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace worm::detail {
+// Bump allocator for short-lived objects released by another thread, e.g. queued events released by the dispatch.
+// Every thread allocates from its own region without any synchronization, the region is rewound once everything
+// allocated from it has been released - typically after every dispatch cycle. Full regions are recycled through
+// a shared pool once their last allocation is released.
+class CycleArena final {
+public:
+    static const inline size_t ALIGNMENT{ alignof(std::max_align_t) };
+
+    static const inline size_t REGION_SIZE{ 64 * 1024 };
+
+    static const inline size_t MAX_POOLED_REGION_COUNT{ 64 };
+
+public:
+    static void* Allocate(const size_t size)
+    {
+        const auto blockSize{ BLOCK_HEADER_SIZE + AlignUp(size) };
+        if (blockSize > REGION_SIZE) {
+            // a region of its own, returned to the heap once released
+            s_heapFallbackCount.fetch_add(1, std::memory_order_relaxed);
+            return AllocateBlock(*CreateRegion(blockSize, 0), blockSize);
+        }
+
+        auto& region{ s_threadRegion.Get(blockSize) };
+        return AllocateBlock(region, blockSize);
+    }
+
+    static void Deallocate(void* memory)
+    {
+        const auto region{ *reinterpret_cast<Region**>(static_cast<unsigned char*>(memory) - BLOCK_HEADER_SIZE) };
+        Release(region);
+    }
+
+    // Allocation counts are collected whenever a region is rewound or recycled.
+    static AllocatorStats GetStats()
+    {
+        AllocatorStats stats;
+        stats.reservedBytes = s_reservedBytes.load(std::memory_order_relaxed);
+        stats.allocationCount = s_allocationCount.load(std::memory_order_relaxed);
+        stats.heapFallbackCount = s_heapFallbackCount.load(std::memory_order_relaxed);
+        stats.blockAllocationCount = s_regionAllocationCount.load(std::memory_order_relaxed);
+        stats.resetCount = s_resetCount.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+private:
+    struct Region {
+        // live allocations plus one for the owning thread
+        std::atomic<size_t> pendingCount;
+
+        size_t capacity;
+
+        size_t offset;
+
+        uint64_t allocationCount;
+
+        unsigned char* GetData()
+        {
+            return reinterpret_cast<unsigned char*>(this) + REGION_HEADER_SIZE;
+        }
+    };
+
+    struct RegionPool {
+        std::mutex mutex;
+
+        std::vector<Region*> regions;
+    };
+
+    class ThreadRegion final {
+    public:
+        ThreadRegion()
+            : m_region{ nullptr }
+        {
+        }
+
+        ~ThreadRegion()
+        {
+            if (m_region) {
+                Release(m_region);
+            }
+        }
+
+    public:
+        Region& Get(const size_t blockSize)
+        {
+            if (m_region && m_region->offset > 0 && m_region->pendingCount.load(std::memory_order_acquire) == 1) {
+                // everything allocated so far has been released
+                CollectAllocations(*m_region);
+                m_region->offset = 0;
+                s_resetCount.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            if (!m_region || m_region->offset + blockSize > m_region->capacity) {
+                if (m_region) {
+                    Release(m_region);
+                }
+                m_region = AcquireRegion();
+            }
+            return *m_region;
+        }
+
+    private:
+        ThreadRegion(const ThreadRegion& other) = delete;
+
+        ThreadRegion& operator=(const ThreadRegion& other) = delete;
+
+        ThreadRegion(ThreadRegion&& other) = delete;
+
+        ThreadRegion& operator=(ThreadRegion&& other) = delete;
+
+    private:
+        Region* m_region;
+    };
+
+private:
+    static size_t AlignUp(const size_t size)
+    {
+        return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    static void* AllocateBlock(Region& region, const size_t blockSize)
+    {
+        const auto block{ region.GetData() + region.offset };
+        region.offset += blockSize;
+        ++region.allocationCount;
+        region.pendingCount.fetch_add(1, std::memory_order_relaxed);
+
+        *reinterpret_cast<Region**>(block) = &region;
+        return block + BLOCK_HEADER_SIZE;
+    }
+
+    static Region* CreateRegion(const size_t capacity, const size_t pendingCount)
+    {
+        s_reservedBytes.fetch_add(capacity, std::memory_order_relaxed);
+        s_regionAllocationCount.fetch_add(1, std::memory_order_relaxed);
+
+        return new (::operator new(REGION_HEADER_SIZE + capacity)) Region{ { pendingCount }, capacity, 0, 0 };
+    }
+
+    static Region* AcquireRegion()
+    {
+        auto& pool{ GetPool() };
+        {
+            std::scoped_lock lock{ pool.mutex };
+
+            if (!pool.regions.empty()) {
+                const auto region{ pool.regions.back() };
+                pool.regions.pop_back();
+                region->pendingCount.store(1, std::memory_order_relaxed);
+                return region;
+            }
+        }
+        return CreateRegion(REGION_SIZE, 1);
+    }
+
+    static void Release(Region* region)
+    {
+        if (region->pendingCount.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        // neither the owning thread nor any allocation references the region anymore
+        CollectAllocations(*region);
+        region->offset = 0;
+
+        if (region->capacity == REGION_SIZE) {
+            auto& pool{ GetPool() };
+
+            std::scoped_lock lock{ pool.mutex };
+
+            if (pool.regions.size() < MAX_POOLED_REGION_COUNT) {
+                pool.regions.push_back(region);
+                return;
+            }
+        }
+
+        s_reservedBytes.fetch_sub(region->capacity, std::memory_order_relaxed);
+        region->~Region();
+        ::operator delete(region);
+    }
+
+    static void CollectAllocations(Region& region)
+    {
+        s_allocationCount.fetch_add(region.allocationCount, std::memory_order_relaxed);
+        region.allocationCount = 0;
+    }
+
+    // Intentionally not released - threads exiting during static destruction may still return their regions.
+    static RegionPool& GetPool()
+    {
+        static const auto pool{ new RegionPool{} };
+        return *pool;
+    }
+
+private:
+    static const inline size_t REGION_HEADER_SIZE{ (sizeof(Region) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT };
+
+    static const inline size_t BLOCK_HEADER_SIZE{ (sizeof(Region*) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT };
+
+    static inline thread_local ThreadRegion s_threadRegion;
+
+    static inline std::atomic<uint64_t> s_reservedBytes{ 0 };
+
+    static inline std::atomic<uint64_t> s_allocationCount{ 0 };
+
+    static inline std::atomic<uint64_t> s_heapFallbackCount{ 0 };
+
+    static inline std::atomic<uint64_t> s_regionAllocationCount{ 0 };
+
+    static inline std::atomic<uint64_t> s_resetCount{ 0 };
+};
+} // namespace worm::detail
+
+#endif
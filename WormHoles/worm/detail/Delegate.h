@@ -0,0 +1,61 @@
+#ifndef __WH_DELEGATE_H__
+#define __WH_DELEGATE_H__
+
+namespace worm::detail {
+// Non-owning, non-allocating callable - an object pointer plus a trampoline instantiated for the handler type.
+template <typename EventType>
+class Delegate final {
+public:
+    Delegate() = default;
+
+public:
+    template <typename HandlerType>
+    static Delegate Create(HandlerType& handler)
+    {
+        return Delegate{ &handler, &Delegate::Invoke<HandlerType> };
+    }
+
+public:
+    void operator()(const EventType& message) const
+    {
+        m_function(m_object, message);
+    }
+
+    bool operator==(const Delegate& other) const
+    {
+        return m_object == other.m_object && m_function == other.m_function;
+    }
+
+    bool operator!=(const Delegate& other) const
+    {
+        return !(*this == other);
+    }
+
+    explicit operator bool() const
+    {
+        return m_function != nullptr;
+    }
+
+private:
+    using FunctionType = void (*)(void* object, const EventType& message);
+
+    Delegate(void* object, FunctionType function)
+        : m_object{ object }
+        , m_function{ function }
+    {
+    }
+
+    template <typename HandlerType>
+    static void Invoke(void* object, const EventType& message)
+    {
+        (*static_cast<HandlerType*>(object))(message);
+    }
+
+private:
+    void* m_object{ nullptr };
+
+    FunctionType m_function{ nullptr };
+};
+} // namespace worm::detail
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef __WH_EPOCH_DOMAIN_H__
+#define __WH_EPOCH_DOMAIN_H__
+
+#include "Singleton.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace worm::detail {
+// Epoch based read-copy-update support.
+// Readers announce the epoch they started in and the handlers they are invoking in a per-thread record,
+// so the read side never writes to a shared cache line. Writers retire unlinked objects which are deleted
+// once no reader can reference them anymore.
+class EpochDomain final : public Singleton<EpochDomain> {
+private:
+    static const inline uint32_t MAX_TRACKED_INVOCATIONS{ 32 };
+
+    struct alignas(64) ThreadRecord {
+        std::atomic<uint64_t> epoch{ 0 };
+
+        std::atomic<uint32_t> invocationDepth{ 0 };
+
+        std::atomic<const void*> invocations[MAX_TRACKED_INVOCATIONS]{};
+
+        uint32_t readDepth{ 0 };
+
+        std::atomic<bool> used{ true };
+
+        ThreadRecord* next{ nullptr };
+    };
+
+public:
+    class ReadGuard final {
+    public:
+        explicit ReadGuard(EpochDomain& domain)
+            : m_record{ domain.GetThreadRecord() }
+        {
+            if (m_record.readDepth++ == 0) {
+                m_record.epoch.store(domain.m_epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+            }
+        }
+
+        ~ReadGuard()
+        {
+            if (--m_record.readDepth == 0) {
+                m_record.epoch.store(0, std::memory_order_release);
+            }
+        }
+
+    public:
+        // Calls the handler unless it has been deactivated, while it runs WaitForInvocations(id) blocks.
+        // The activity check has to be a sequentially consistent load.
+        template <typename ActiveCheckType, typename HandlerType>
+        void Invoke(const void* id, ActiveCheckType&& isActive, HandlerType&& handler)
+        {
+            const auto depth{ m_record.invocationDepth.load(std::memory_order_relaxed) };
+            if (depth < MAX_TRACKED_INVOCATIONS) {
+                m_record.invocations[depth].store(id, std::memory_order_relaxed);
+            }
+            m_record.invocationDepth.store(depth + 1, std::memory_order_seq_cst);
+
+            struct InvocationScope {
+                ~InvocationScope()
+                {
+                    record.invocationDepth.store(depth, std::memory_order_release);
+                }
+
+                ThreadRecord& record;
+
+                const uint32_t depth;
+            } scope{ m_record, depth };
+
+            if (isActive()) {
+                handler();
+            }
+        }
+
+    private:
+        ReadGuard(const ReadGuard& other) = delete;
+
+        ReadGuard& operator=(const ReadGuard& other) = delete;
+
+        ReadGuard(ReadGuard&& other) = delete;
+
+        ReadGuard& operator=(ReadGuard&& other) = delete;
+
+    private:
+        ThreadRecord& m_record;
+    };
+
+public:
+    template <typename ObjectType>
+    void Retire(ObjectType* object)
+    {
+        Retire(object, [](void* obj) { delete static_cast<ObjectType*>(obj); });
+    }
+
+    void Retire(void* object, void (*deleter)(void*))
+    {
+        const auto epoch{ m_epoch.fetch_add(1, std::memory_order_seq_cst) + 1 };
+        {
+            std::scoped_lock lock{ m_retiredMutex };
+
+            m_retired.push_back({ object, deleter, epoch });
+        }
+
+        Reclaim();
+    }
+
+    // Waits until no other thread is invoking a handler with the given id. The handler has to be deactivated before.
+    void WaitForInvocations(const void* id)
+    {
+        const auto* ownRecord{ s_threadRecord.record };
+
+        for (auto record{ m_records.load(std::memory_order_acquire) }; record; record = record->next) {
+            if (record == ownRecord) {
+                continue;
+            }
+
+            while (IsInvoking(*record, id)) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Deletes the retired objects no reader can reference anymore.
+    void Reclaim()
+    {
+        auto minEpoch{ std::numeric_limits<uint64_t>::max() };
+        for (auto record{ m_records.load(std::memory_order_acquire) }; record; record = record->next) {
+            const auto epoch{ record->epoch.load(std::memory_order_seq_cst) };
+            if (epoch != 0 && epoch < minEpoch) {
+                minEpoch = epoch;
+            }
+        }
+
+        std::vector<RetiredObject> reclaimable;
+        {
+            std::scoped_lock lock{ m_retiredMutex };
+
+            auto it{ std::partition(m_retired.begin(), m_retired.end(), [minEpoch](const RetiredObject& retired) { return retired.epoch > minEpoch; }) };
+            reclaimable.assign(it, m_retired.end());
+            m_retired.erase(it, m_retired.end());
+        }
+
+        for (const auto& retired : reclaimable) {
+            retired.deleter(retired.object);
+        }
+    }
+
+private:
+    struct RetiredObject {
+        void* object;
+
+        void (*deleter)(void*);
+
+        uint64_t epoch;
+    };
+
+    struct ThreadRecordHandle {
+        ~ThreadRecordHandle()
+        {
+            if (record) {
+                record->used.store(false, std::memory_order_release);
+            }
+        }
+
+        ThreadRecord* record;
+    };
+
+private:
+    ThreadRecord& GetThreadRecord()
+    {
+        if (s_threadRecord.record) {
+            return *s_threadRecord.record;
+        }
+
+        // reuse a record of an exited thread
+        for (auto record{ m_records.load(std::memory_order_acquire) }; record; record = record->next) {
+            bool used{ false };
+            if (!record->used.load(std::memory_order_relaxed) && record->used.compare_exchange_strong(used, true, std::memory_order_acquire)) {
+                s_threadRecord.record = record;
+                return *record;
+            }
+        }
+
+        auto record{ new ThreadRecord{} };
+        record->next = m_records.load(std::memory_order_relaxed);
+        while (!m_records.compare_exchange_weak(record->next, record, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+
+        s_threadRecord.record = record;
+        return *record;
+    }
+
+    static bool IsInvoking(const ThreadRecord& record, const void* id)
+    {
+        const auto depth{ record.invocationDepth.load(std::memory_order_seq_cst) };
+        if (depth > MAX_TRACKED_INVOCATIONS) {
+            // too deep to be tracked -> be conservative
+            return true;
+        }
+
+        for (uint32_t i = 0; i < depth; ++i) {
+            if (record.invocations[i].load(std::memory_order_acquire) == id) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    EpochDomain() = default;
+
+    // Thread records are intentionally not released - threads exiting during static destruction may still touch them.
+    ~EpochDomain()
+    {
+        for (const auto& retired : m_retired) {
+            retired.deleter(retired.object);
+        }
+    }
+
+private:
+    friend class Singleton<EpochDomain>;
+
+private:
+    static inline thread_local ThreadRecordHandle s_threadRecord{ nullptr };
+
+    std::atomic<uint64_t> m_epoch{ 1 };
+
+    std::atomic<ThreadRecord*> m_records{ nullptr };
+
+    std::mutex m_retiredMutex;
+
+    std::vector<RetiredObject> m_retired;
+};
+} // namespace worm::detail
+
+#endif
@@ -1,150 +1,1066 @@
 #ifndef __WH_EVENT_CHANNEL_QUEUE_H__
 #define __WH_EVENT_CHANNEL_QUEUE_H__
 
+#include "BoundedQueue.h"
+#include "ChannelMetrics.h"
+#include "CoalescingQueue.h"
+#include "Construct.h"
+#include "Delegate.h"
+#include "EpochDomain.h"
 #include "EventChannelQueueManager.h"
-#include "RingBuffer.h"
-#include "ThreadPool.h"
+#include "MpscQueue.h"
+#include "ProducerBufferedQueue.h"
+#include "SlotMap.h"
+#include "Strand.h"
+#include "TimerWheel.h"
 
-#include <functional>
-#include <future>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
 #include <vector>
 
 namespace worm::detail {
+enum class AsyncPolicy {
+    ORDERED,
+    ORDERED_PER_KEY,
+    PARALLEL
+};
+
+// Where the unbounded QUEUED events are allocated.
+enum class QueuedAllocation {
+    HEAP,
+    CYCLE_ARENA
+};
+
+// Sees the messages posted to a channel, see EventChannelQueue::SetPostObserver.
+template <typename EventType>
+class IPostObserver {
+public:
+    virtual ~IPostObserver() = default;
+
+    virtual void OnPosted(const EventType& message, const DispatchType dispatchType, const Priority priority) = 0;
+};
+
 template <typename EventType>
 class EventChannelQueue final : public Singleton<EventChannelQueue<EventType>>, public IEventChannelQueue {
+public:
+    using KeyFunction = size_t (*)(const EventType& message);
+
 public:
     template <typename EventHandlerType>
-    void Add(EventHandlerType& handler)
+    SlotHandle Add(EventHandlerType& handler)
     {
         std::scoped_lock lock{ m_mutex };
 
-        m_handlers.emplace_back(CreateHandler(handler));
-        m_originalPointers.emplace_back(&handler);
+        const auto handle{ m_subscriptions.Emplace(Subscriber{ Delegate<EventType>::Create(handler), std::nullopt }) };
+        m_handlersDirty.store(true, std::memory_order_release);
+        return handle;
     }
 
+    // The handler is called only for events with the routing key (from the routing key function).
     template <typename EventHandlerType>
-    void Remove(EventHandlerType& handler)
+    SlotHandle Add(EventHandlerType& handler, const size_t routingKey)
     {
         std::scoped_lock lock{ m_mutex };
 
-        const auto it{ std::find(m_originalPointers.begin(), m_originalPointers.end(), &handler) };
-        if (it == m_originalPointers.end()) {
-            throw std::runtime_error("Tried to remove a handler that is not in the list.");
+        if (!m_routingKeyFunction) {
+            throw std::runtime_error("Routing key function has to be set before adding a routed handler.");
         }
 
-        const auto idx{ it - m_originalPointers.begin() };
-        m_handlers.erase(m_handlers.begin() + idx);
-        m_originalPointers.erase(it);
+        const auto handle{ m_subscriptions.Emplace(Subscriber{ Delegate<EventType>::Create(handler), routingKey }) };
+        m_handlersDirty.store(true, std::memory_order_release);
+        return handle;
     }
 
-    void Post(const EventType& message)
+    // nullptr turns the routing off (default), it can not be done while there are routed handlers.
+    void SetRoutingKeyFunction(const KeyFunction keyFunction)
     {
         std::scoped_lock lock{ m_mutex };
 
+        if (!keyFunction) {
+            m_subscriptions.ForEach([](const SlotHandle&, const Subscriber& subscriber) {
+                if (subscriber.routingKey) {
+                    throw std::runtime_error("Routing key function can not be reset while there are routed handlers.");
+                }
+            });
+        }
+
+        m_routingKeyFunction = keyFunction;
+        m_handlersDirty.store(true, std::memory_order_release);
+    }
+
+    void Remove(const SlotHandle handle)
+    {
+        const void* id;
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            if (!m_subscriptions.Erase(handle)) {
+                throw std::runtime_error("Tried to remove a handler that is not in the list.");
+            }
+
+            id = &m_subscriptions.GetGeneration(handle.index);
+            m_handlersDirty.store(true, std::memory_order_release);
+        }
+
+        // a concurrent dispatch might still be calling the handler
+        m_epochDomain.WaitForInvocations(id);
+    }
+
+    // Prefer removal by the handle returned from Add, this has to search for the handler.
+    template <typename EventHandlerType>
+    void Remove(EventHandlerType& handler)
+    {
+        SlotHandle handle;
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            const auto delegate{ Delegate<EventType>::Create(handler) };
+            m_subscriptions.ForEach([&](const SlotHandle& subscription, const Subscriber& subscribed) {
+                if (subscribed.delegate == delegate) {
+                    handle = subscription;
+                }
+            });
+        }
+
+        Remove(handle);
+    }
+
+    void Post(const EventType& message)
+    {
+        m_metrics.OnPosted();
+
         DispatchEvent(message);
     }
 
-    void PostQueued(const EventType& message)
+    template <typename IteratorType>
+    void PostBatch(IteratorType first, IteratorType last)
     {
-        std::scoped_lock lock{ m_mutex };
+        for (; first != last; ++first) {
+            m_metrics.OnPosted();
+
+            DispatchEvent(*first);
+        }
+    }
+
+    bool PostQueued(const EventType& message, const Priority priority = Priority::NORMAL)
+    {
+        return EmplaceQueuedWithPriority(priority, message);
+    }
+
+    bool PostQueued(EventType&& message, const Priority priority = Priority::NORMAL)
+    {
+        return EmplaceQueuedWithPriority(priority, std::move(message));
+    }
+
+    template <typename... Args>
+    bool EmplaceQueued(Args&&... args)
+    {
+        return EmplaceQueuedWithPriority(Priority::NORMAL, std::forward<Args>(args)...);
+    }
+
+    // Returns false if the event was rejected by a bounded queue with the FAIL policy.
+    template <typename... Args>
+    bool EmplaceQueuedWithPriority(const Priority priority, Args&&... args)
+    {
+        m_metrics.OnPosted();
+
+        auto& lane{ GetQueuedLane(priority) };
+        if (lane.coalescedEvents) {
+            EmplaceCoalesced(priority, std::forward<Args>(args)...);
+            return true;
+        }
+
+        if (lane.boundedEvents) {
+            return OnBoundedPush(priority, lane.boundedEvents->Emplace(std::forward<Args>(args)...));
+        }
+
+        if (lane.bufferedEvents) {
+            lane.bufferedEvents->Emplace(std::forward<Args>(args)...);
+            m_metrics.OnQueued(GetLaneIndex(priority));
+            return true;
+        }
+
+        lane.events.Emplace(std::forward<Args>(args)...);
+        m_metrics.OnQueued(GetLaneIndex(priority));
+        return true;
+    }
+
+    // Returns the number of accepted events. A batch is published atomically only if the queue is unbounded.
+    template <typename IteratorType>
+    size_t PostQueuedBatch(IteratorType first, IteratorType last, const Priority priority = Priority::NORMAL)
+    {
+        const auto count{ static_cast<size_t>(std::distance(first, last)) };
+        m_metrics.OnPosted(count);
+
+        auto& lane{ GetQueuedLane(priority) };
+        if (lane.coalescedEvents) {
+            for (; first != last; ++first) {
+                EmplaceCoalesced(priority, *first);
+            }
+            return count;
+        }
+
+        if (lane.boundedEvents) {
+            size_t acceptedCount{ 0 };
+            for (; first != last; ++first) {
+                if (OnBoundedPush(priority, lane.boundedEvents->Emplace(*first))) {
+                    ++acceptedCount;
+                }
+            }
+            return acceptedCount;
+        }
+
+        if (lane.bufferedEvents) {
+            lane.bufferedEvents->PushRange(first, last);
+            m_metrics.OnQueued(GetLaneIndex(priority), count);
+            return count;
+        }
+
+        lane.events.PushRange(first, last);
+        m_metrics.OnQueued(GetLaneIndex(priority), count);
+        return count;
+    }
+
+    // Capacity of 0 makes the queue unbounded (default), the capacity applies to every priority.
+    // It can not be changed while there are queued events and must not be called concurrently with posting.
+    void SetQueuedCapacity(const size_t capacity, const OverflowPolicy policy)
+    {
+        std::scoped_lock lock{ m_queuedMutex };
+
+        if (HasQueuedEvents()) {
+            throw std::runtime_error("Queued capacity can not be changed while there are queued events.");
+        }
+
+        if (capacity > 0 && m_coalescingKeyFunction) {
+            throw std::runtime_error("Coalescing queued events can not be bounded.");
+        }
+
+        if (capacity > 0 && GetQueuedLane(Priority::NORMAL).bufferedEvents) {
+            throw std::runtime_error("Queued events buffered per producer can not be bounded.");
+        }
+
+        for (auto& lane : m_queuedLanes) {
+            lane.boundedEvents.reset(capacity > 0 ? new BoundedQueue<EventType>(capacity, policy) : nullptr);
+        }
+    }
+
+    // Bounded and coalescing queues are preallocated, the allocation applies to the unbounded queues only.
+    // Same restrictions as for SetQueuedCapacity apply.
+    void SetQueuedAllocation(const QueuedAllocation allocation)
+    {
+        std::scoped_lock lock{ m_queuedMutex };
+
+        if (HasQueuedEvents()) {
+            throw std::runtime_error("Queued allocation can not be changed while there are queued events.");
+        }
+
+        for (auto& lane : m_queuedLanes) {
+            lane.events.SetCycleArena(allocation == QueuedAllocation::CYCLE_ARENA);
+        }
+    }
+
+    // Every producer thread stages its queued events in a buffer of its own, so that producers do not share any
+    // written cache line. The events of one producer are dispatched in the posting order, the events of different
+    // producers are not ordered. Same restrictions as for SetQueuedCapacity apply.
+    void SetQueuedProducerBuffering(const bool enabled)
+    {
+        std::scoped_lock lock{ m_queuedMutex };
+
+        if (HasQueuedEvents()) {
+            throw std::runtime_error("Queued buffering can not be changed while there are queued events.");
+        }
+
+        if (enabled && (GetQueuedLane(Priority::NORMAL).boundedEvents || m_coalescingKeyFunction)) {
+            throw std::runtime_error("Bounded or coalescing queued events can not be buffered per producer.");
+        }
+
+        for (auto& lane : m_queuedLanes) {
+            lane.bufferedEvents.reset(enabled ? new ProducerBufferedQueue<EventType>() : nullptr);
+        }
+    }
+
+    // Queued events with the same key (from keyFunction) are coalesced - only the latest one is dispatched,
+    // at the position of the first one. The events of different priorities are coalesced separately.
+    // nullptr turns the coalescing off (default). Same restrictions as for SetQueuedCapacity apply.
+    void SetQueuedCoalescing(const KeyFunction keyFunction)
+    {
+        std::scoped_lock lock{ m_queuedMutex };
 
-        m_eventsToDeliver.emplace_back(message);
+        if (HasQueuedEvents()) {
+            throw std::runtime_error("Queued coalescing can not be changed while there are queued events.");
+        }
+
+        if (keyFunction && (GetQueuedLane(Priority::NORMAL).boundedEvents || GetQueuedLane(Priority::NORMAL).bufferedEvents)) {
+            throw std::runtime_error("Only unbuffered unbounded queued events can be coalesced.");
+        }
+
+        m_coalescingKeyFunction = keyFunction;
+        for (auto& lane : m_queuedLanes) {
+            lane.coalescedEvents.reset(keyFunction ? new CoalescingQueue<EventType>() : nullptr);
+        }
     }
 
     void PostAsync(const EventType& message)
     {
-        std::scoped_lock lock{ m_asyncTasksMutex };
+        EmplaceAsync(message);
+    }
 
-        m_asyncTasks.MovePush(std::move(m_threadPool.Enqueue([this, message]() {
-            std::scoped_lock lock{ this->m_mutex };
+    void PostAsync(EventType&& message)
+    {
+        EmplaceAsync(std::move(message));
+    }
 
-            DispatchEvent(message);
-        })));
+    // Never waits for the handlers, failures of the handlers are reported by DispatchAllAsync, PollAsync or WaitAsync.
+    template <typename... Args>
+    void EmplaceAsync(Args&&... args)
+    {
+        ScheduleAsyncEvent(true, std::forward<Args>(args)...);
+        m_metrics.OnPosted();
+        m_metrics.OnAsyncScheduled();
+    }
+
+    // The whole batch is handled by a single task, a failing event does not stop the rest of the batch.
+    // With the ORDERED_PER_KEY policy the batch is split per lane.
+    template <typename IteratorType>
+    void PostAsyncBatch(IteratorType first, IteratorType last)
+    {
+        if (first == last) {
+            return;
+        }
+
+        const auto count{ static_cast<uint64_t>(std::distance(first, last)) };
+
+        ScheduleAsyncBatch(true, first, last);
+        m_metrics.OnPosted(count);
+        m_metrics.OnAsyncScheduled(count);
+    }
 
-        if (m_asyncTasks.IsFull()) {
-            DispatchAllAsyncInternal();
+    void PostDetached(const EventType& message)
+    {
+        EmplaceDetached(message);
+    }
+
+    void PostDetached(EventType&& message)
+    {
+        EmplaceDetached(std::move(message));
+    }
+
+    template <typename... Args>
+    void EmplaceDetached(Args&&... args)
+    {
+        ScheduleAsyncEvent(false, std::forward<Args>(args)...);
+        m_metrics.OnPosted();
+        m_metrics.OnAsyncScheduled();
+    }
+
+    template <typename IteratorType>
+    void PostDetachedBatch(IteratorType first, IteratorType last)
+    {
+        if (first == last) {
+            return;
         }
+
+        const auto count{ static_cast<uint64_t>(std::distance(first, last)) };
+
+        ScheduleAsyncBatch(false, first, last);
+        m_metrics.OnPosted(count);
+        m_metrics.OnAsyncScheduled(count);
+    }
+
+    // The message is posted with the dispatch type by the first AdvanceTimers at or after the deadline.
+    template <typename... Args>
+    SlotHandle PostAt(const std::chrono::steady_clock::time_point deadline, const DispatchType dispatchType, const Priority priority, Args&&... args)
+    {
+        std::scoped_lock lock{ m_timersMutex };
+
+        if (!m_timers) {
+            m_timerEpoch = std::chrono::steady_clock::now();
+            m_timers = std::make_unique<TimerWheel<DelayedEvent>>();
+        }
+
+        // rounded up, so a timer never fires early
+        const auto untilDeadline{ std::max(deadline - m_timerEpoch, std::chrono::steady_clock::duration::zero()) };
+        const auto tick{ static_cast<uint64_t>((untilDeadline + TIMER_RESOLUTION - std::chrono::steady_clock::duration{ 1 }) / TIMER_RESOLUTION) };
+
+        const auto handle{ m_timers->Schedule(tick, dispatchType, priority, std::forward<Args>(args)...) };
+        m_pendingTimerCount.store(m_timers->Size(), std::memory_order_release);
+        return handle;
+    }
+
+    // Returns false if the timer has already fired or has been cancelled.
+    bool CancelTimer(const SlotHandle handle)
+    {
+        std::scoped_lock lock{ m_timersMutex };
+
+        if (!m_timers || !m_timers->Cancel(handle)) {
+            return false;
+        }
+        m_pendingTimerCount.store(m_timers->Size(), std::memory_order_release);
+        return true;
+    }
+
+    void AdvanceTimers(const std::chrono::steady_clock::time_point now) override
+    {
+        if (m_pendingTimerCount.load(std::memory_order_acquire) == 0) {
+            return;
+        }
+
+        size_t dueCount;
+        {
+            std::scoped_lock lock{ m_timersMutex };
+
+            dueCount = m_timers->Advance(static_cast<uint64_t>(std::max(now - m_timerEpoch, std::chrono::steady_clock::duration::zero()) / TIMER_RESOLUTION));
+        }
+
+        // the events are posted without the lock, so handlers can schedule timers - those are left for the next call
+        for (; dueCount > 0; --dueCount) {
+            auto event{ PopDueTimer() };
+            if (!event) {
+                break;
+            }
+            PostDue(std::move(*event));
+        }
+    }
+
+    // The lane count defaults to the executor worker count, ORDERED always uses a single lane.
+    // Can not be changed while there are pending async events and must not be called concurrently with posting.
+    void SetAsyncPolicy(const AsyncPolicy policy, const size_t laneCount, const KeyFunction keyFunction)
+    {
+        if (policy == AsyncPolicy::ORDERED_PER_KEY && !keyFunction) {
+            throw std::runtime_error("ORDERED_PER_KEY async policy requires a key function.");
+        }
+
+        for (const auto& lane : m_asyncLanes) {
+            if (lane->GetPendingCount() > 0) {
+                throw std::runtime_error("Async policy can not be changed while there are pending async events.");
+            }
+        }
+
+        const auto executorWorkerCount{ m_manager.GetExecutor().GetWorkerCount() };
+        CreateAsyncLanes(policy == AsyncPolicy::ORDERED ? 1 : (laneCount > 0 ? laneCount : executorWorkerCount));
+        m_asyncKeyFunction = policy == AsyncPolicy::ORDERED_PER_KEY ? keyFunction : nullptr;
     }
 
     void DispatchAllQueued() override
     {
-        std::scoped_lock lock{ m_mutex };
+        std::scoped_lock lock{ m_queuedMutex };
+
+        for (size_t i = PRIORITY_COUNT; i-- > 0;) {
+            DispatchQueuedInternal(static_cast<Priority>(i));
+        }
+    }
+
+    void DispatchQueued(const Priority priority) override
+    {
+        std::scoped_lock lock{ m_queuedMutex };
 
-        DispatchAllQueuedInternal();
+        DispatchQueuedInternal(priority);
+    }
+
+    size_t DispatchQueued(const Priority priority, const size_t maxCount) override
+    {
+        std::scoped_lock lock{ m_queuedMutex };
+
+        return DispatchQueuedInternal(priority, maxCount);
+    }
+
+    uint64_t GetQueuedCount() const override
+    {
+        return m_metrics.GetQueuedCount();
+    }
+
+    uint64_t GetQueuedCount(const Priority priority) const override
+    {
+        return m_metrics.GetQueuedCount(GetLaneIndex(priority));
     }
 
     void DispatchAllAsync() override
     {
-        std::scoped_lock lock{ m_asyncTasksMutex };
+        // events posted while waiting are left for the next call
+        const auto tickets{ GetAsyncTickets() };
+        for (size_t i = 0; i < m_asyncLanes.size(); ++i) {
+            m_asyncLanes[i]->Wait(tickets[i]);
+        }
+        RethrowAsyncFailure();
+    }
+
+    bool PollAsync() override
+    {
+        const auto isIdle{ std::all_of(m_asyncLanes.begin(), m_asyncLanes.end(), [](const auto& lane) { return lane->GetPendingCount() == 0; }) };
+        RethrowAsyncFailure();
+        return isIdle;
+    }
+
+    bool WaitAsync(const std::chrono::steady_clock::time_point deadline) override
+    {
+        const auto tickets{ GetAsyncTickets() };
+        bool isIdle{ true };
+        for (size_t i = 0; i < m_asyncLanes.size(); ++i) {
+            if (!m_asyncLanes[i]->WaitUntil(tickets[i], deadline)) {
+                isIdle = false;
+                break;
+            }
+        }
+        RethrowAsyncFailure();
+        return isIdle;
+    }
+
+    uint64_t GetPendingAsyncCount() const override
+    {
+        return m_metrics.GetAsyncInFlightCount();
+    }
+
+    bool IsQueuedDispatchOnCallerThread() const override
+    {
+        return m_queuedDispatchOnCallerThread.load(std::memory_order_relaxed);
+    }
+
+    void SetQueuedDispatchOnCallerThread(const bool onCallerThread)
+    {
+        m_queuedDispatchOnCallerThread.store(onCallerThread, std::memory_order_relaxed);
+    }
+
+    // The observer is called on the posting thread for every message posted through the bus and every fired timer,
+    // before the message is handed to its queue - so it sees also the messages a full or coalescing queue drops.
+    // A channel has at most one observer, nullptr removes it. Must not be changed while messages are posted.
+    void SetPostObserver(IPostObserver<EventType>* observer)
+    {
+        if (observer) {
+            IPostObserver<EventType>* expected{ nullptr };
+            if (!m_postObserver.compare_exchange_strong(expected, observer, std::memory_order_acq_rel)) {
+                throw std::runtime_error("The channel already has a post observer.");
+            }
+            return;
+        }
+        m_postObserver.store(nullptr, std::memory_order_release);
+    }
 
-        DispatchAllAsyncInternal();
+    bool HasPostObserver() const
+    {
+        return m_postObserver.load(std::memory_order_acquire) != nullptr;
     }
 
+    void NotifyPosted(const EventType& message, const DispatchType dispatchType, const Priority priority) const
+    {
+        if (const auto observer{ m_postObserver.load(std::memory_order_acquire) }) {
+            observer->OnPosted(message, dispatchType, priority);
+        }
+    }
+
+    // Serializes the dispatches of the channel like a single mutex held over the handler calls. A handler may post
+    // the same event type again from its call.
+    void SetSerializedDispatch(const bool serialized)
+    {
+        m_serializedDispatch.store(serialized, std::memory_order_relaxed);
+    }
+
+    ChannelMetricsSnapshot GetMetrics() const override
+    {
+        ChannelMetricsSnapshot snapshot{};
+        snapshot.eventTypeName = GetTypeName<EventType>();
+        m_metrics.Collect(snapshot);
+        return snapshot;
+    }
+
+private:
+    struct Subscriber {
+        Delegate<EventType> delegate;
+
+        std::optional<size_t> routingKey;
+    };
+
+    struct Subscription {
+        Delegate<EventType> delegate;
+
+        const std::atomic<uint32_t>* generation;
+
+        uint32_t subscribedGeneration;
+    };
+
+    // immutable once published, rebuilt from the subscriptions on the first dispatch after Add/Remove
+    struct HandlerList {
+        std::vector<Subscription> wildcards;
+
+        // routing key -> handlers subscribed with the key
+        std::unordered_map<size_t, std::vector<Subscription>> routed;
+
+        KeyFunction routingKeyFunction{ nullptr };
+    };
+
+    struct DelayedEvent {
+        template <typename... Args>
+        DelayedEvent(const DispatchType type, const Priority queuedPriority, Args&&... args)
+            : message(Construct<EventType>(std::forward<Args>(args)...))
+            , dispatchType{ type }
+            , priority{ queuedPriority }
+        {
+        }
+
+        EventType message;
+
+        DispatchType dispatchType;
+
+        Priority priority;
+    };
+
+    struct AsyncEvent {
+        template <typename... Args>
+        explicit AsyncEvent(const bool isTracked, Args&&... args)
+            : message(Construct<EventType>(std::forward<Args>(args)...))
+            , tracked{ isTracked }
+        {
+        }
+
+        EventType message;
+
+        // failures of the untracked (detached) events are dropped
+        bool tracked;
+    };
+
+    struct AsyncBatch {
+        template <typename IteratorType>
+        AsyncBatch(const bool isTracked, IteratorType first, IteratorType last)
+            : messages(first, last)
+            , tracked{ isTracked }
+        {
+        }
+
+        AsyncBatch(const bool isTracked, std::vector<EventType>&& batch)
+            : messages{ std::move(batch) }
+            , tracked{ isTracked }
+        {
+        }
+
+        std::vector<EventType> messages;
+
+        bool tracked;
+    };
+
+    using AsyncItem = std::variant<AsyncEvent, AsyncBatch>;
+
 private:
-    void DispatchAllQueuedInternal()
+    struct QueuedLane {
+        MpscQueue<EventType> events;
+
+        std::unique_ptr<BoundedQueue<EventType>> boundedEvents;
+
+        std::unique_ptr<CoalescingQueue<EventType>> coalescedEvents;
+
+        std::unique_ptr<ProducerBufferedQueue<EventType>> bufferedEvents;
+    };
+
+    static size_t GetLaneIndex(const Priority priority)
+    {
+        return static_cast<size_t>(priority);
+    }
+
+    QueuedLane& GetQueuedLane(const Priority priority)
+    {
+        return m_queuedLanes[GetLaneIndex(priority)];
+    }
+
+    bool HasQueuedEvents() const
     {
-        for (const auto& message : m_eventsToDeliver) {
+        return std::any_of(std::begin(m_queuedLanes), std::end(m_queuedLanes), [](const QueuedLane& lane) {
+            return !lane.events.IsEmpty() || (lane.boundedEvents && !lane.boundedEvents->IsEmpty()) || (lane.coalescedEvents && !lane.coalescedEvents->IsEmpty())
+                || (lane.bufferedEvents && !lane.bufferedEvents->IsEmpty());
+        });
+    }
+
+    template <typename... Args>
+    void EmplaceCoalesced(const Priority priority, Args&&... args)
+    {
+        auto& lane{ GetQueuedLane(priority) };
+        bool replaced;
+        if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, EventType> && ...)) {
+            replaced = lane.coalescedEvents->Emplace(m_coalescingKeyFunction(args...), std::forward<Args>(args)...);
+        } else {
+            // the key is known only once the message is constructed
+            EventType message(Construct<EventType>(std::forward<Args>(args)...));
+            replaced = lane.coalescedEvents->Emplace(m_coalescingKeyFunction(message), std::move(message));
+        }
+
+        if (replaced) {
+            m_metrics.OnCoalesced();
+        } else {
+            m_metrics.OnQueued(GetLaneIndex(priority));
+        }
+    }
+
+    size_t DispatchQueuedInternal(const Priority priority, const size_t maxCount = std::numeric_limits<size_t>::max())
+    {
+        const auto consumer{ [this, priority](const EventType& message) {
+            m_metrics.OnDequeued(GetLaneIndex(priority));
+
             DispatchEvent(message);
+        } };
+
+        auto& lane{ GetQueuedLane(priority) };
+        if (lane.coalescedEvents) {
+            return lane.coalescedEvents->Consume(maxCount, consumer);
+        } else if (lane.boundedEvents) {
+            return lane.boundedEvents->Consume(maxCount, consumer);
+        } else if (lane.bufferedEvents) {
+            return lane.bufferedEvents->Consume(maxCount, consumer);
         }
-        m_eventsToDeliver.clear();
+        return lane.events.Consume(maxCount, consumer);
     }
 
-    void DispatchAllAsyncInternal()
+    std::optional<DelayedEvent> PopDueTimer()
     {
-        while (!m_asyncTasks.IsEmpty()) {
-            m_asyncTasks.MovePop().get();
+        std::scoped_lock lock{ m_timersMutex };
+
+        auto event{ m_timers->PopDue() };
+        m_pendingTimerCount.store(m_timers->Size(), std::memory_order_release);
+        return event;
+    }
+
+    void PostDue(DelayedEvent&& event)
+    {
+        NotifyPosted(event.message, event.dispatchType, event.priority);
+
+        switch (event.dispatchType) {
+        case DispatchType::ASYNC:
+            PostAsync(std::move(event.message));
+            break;
+        case DispatchType::QUEUED:
+            PostQueued(std::move(event.message), event.priority);
+            break;
+        case DispatchType::ASYNC_DETACHED:
+            PostDetached(std::move(event.message));
+            break;
+        default:
+            Post(event.message);
+            break;
         }
     }
 
-private:
-    EventChannelQueue()
+    bool OnBoundedPush(const Priority priority, const PushResult result)
+    {
+        switch (result) {
+        case PushResult::PUSHED:
+            m_metrics.OnQueued(GetLaneIndex(priority));
+            return true;
+        case PushResult::DROPPED_OLDEST:
+            // the new event replaced the dropped one, so the depth does not change
+            m_metrics.OnDropped();
+            return true;
+        case PushResult::DROPPED_NEWEST:
+            // the event is discarded, so it is not reported as accepted
+            m_metrics.OnDropped();
+            return false;
+        default:
+            return false;
+        }
+    }
+
+    void RethrowAsyncFailure()
+    {
+        if (!m_hasAsyncFailure.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::exception_ptr failure;
+        {
+            std::scoped_lock lock{ m_asyncFailureMutex };
+
+            failure = std::exchange(m_asyncFailure, nullptr);
+            m_hasAsyncFailure.store(false, std::memory_order_relaxed);
+        }
+
+        if (failure) {
+            std::rethrow_exception(failure);
+        }
+    }
+
+    template <typename... Args>
+    void ScheduleAsyncEvent(const bool tracked, Args&&... args)
+    {
+        if (!m_asyncKeyFunction) {
+            GetNextAsyncLane().Emplace(std::in_place_type<AsyncEvent>, tracked, std::forward<Args>(args)...);
+            return;
+        }
+
+        if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, EventType> && ...)) {
+            const auto key{ m_asyncKeyFunction(args...) };
+            GetAsyncLane(key).Emplace(std::in_place_type<AsyncEvent>, tracked, std::forward<Args>(args)...);
+        } else {
+            // the key is known only once the message is constructed
+            EventType message(Construct<EventType>(std::forward<Args>(args)...));
+            const auto key{ m_asyncKeyFunction(message) };
+            GetAsyncLane(key).Emplace(std::in_place_type<AsyncEvent>, tracked, std::move(message));
+        }
+    }
+
+    template <typename IteratorType>
+    void ScheduleAsyncBatch(const bool tracked, IteratorType first, IteratorType last)
+    {
+        if (!m_asyncKeyFunction) {
+            GetNextAsyncLane().Emplace(std::in_place_type<AsyncBatch>, tracked, first, last);
+            return;
+        }
+
+        // messages of one key have to stay on the same lane
+        std::vector<std::vector<EventType>> laneBatches(m_asyncLanes.size());
+        for (; first != last; ++first) {
+            auto&& message{ *first };
+            laneBatches[m_asyncKeyFunction(message) % m_asyncLanes.size()].emplace_back(std::forward<decltype(message)>(message));
+        }
+
+        for (size_t i = 0; i < laneBatches.size(); ++i) {
+            if (!laneBatches[i].empty()) {
+                m_asyncLanes[i]->Emplace(std::in_place_type<AsyncBatch>, tracked, std::move(laneBatches[i]));
+            }
+        }
+    }
+
+    std::vector<uint64_t> GetAsyncTickets() const
+    {
+        std::vector<uint64_t> tickets;
+        tickets.reserve(m_asyncLanes.size());
+        for (const auto& lane : m_asyncLanes) {
+            tickets.push_back(lane->GetTicket());
+        }
+        return tickets;
+    }
+
+    Strand<AsyncItem>& GetAsyncLane(const size_t key)
+    {
+        return *m_asyncLanes[key % m_asyncLanes.size()];
+    }
+
+    Strand<AsyncItem>& GetNextAsyncLane()
+    {
+        if (m_asyncLanes.size() == 1) {
+            return *m_asyncLanes.front();
+        }
+        return GetAsyncLane(m_nextAsyncLane.fetch_add(1, std::memory_order_relaxed));
+    }
+
+    void CreateAsyncLanes(const size_t laneCount)
+    {
+        m_asyncLanes.clear();
+        for (size_t i = 0; i < laneCount; ++i) {
+            m_asyncLanes.emplace_back(std::make_unique<Strand<AsyncItem>>(m_manager.GetExecutor(), &EventChannelQueue::DispatchAsyncItem, this));
+        }
+    }
+
+public:
+    // A channel of an event bus, the process-wide channel is accessed by Instance().
+    explicit EventChannelQueue(EventChannelQueueManager& manager)
         : Singleton<EventChannelQueue<EventType>>()
+        , m_manager{ manager }
     {
-        EventChannelQueueManager::Instance().Add(*this);
+        CreateAsyncLanes(1);
+
+        m_manager.Add(*this);
     }
 
     ~EventChannelQueue()
     {
-        EventChannelQueueManager::Instance().Remove(*this);
+        m_manager.Remove(*this);
+
+        // pending async events still need the handlers
+        for (const auto& lane : m_asyncLanes) {
+            lane->Wait();
+        }
+        m_asyncLanes.clear();
+
+        delete m_handlers.load();
+    }
+
+private:
+    EventChannelQueue()
+        : EventChannelQueue(EventChannelQueueManager::Instance())
+    {
     }
 
 private:
     void DispatchEvent(const EventType& message)
     {
-        for (size_t i = 0; i < m_handlers.size(); ++i) {
-            const auto& handler{ m_handlers[i] };
-            handler(message);
+        if (m_handlersDirty.load(std::memory_order_acquire)) {
+            RefreshHandlers();
+        }
+
+        std::unique_lock<std::recursive_mutex> serializedLock;
+        if (m_serializedDispatch.load(std::memory_order_relaxed)) {
+            serializedLock = std::unique_lock{ m_dispatchMutex };
+        }
+
+        ChannelMetrics::DispatchScope metricsScope{ m_metrics };
+
+        EpochDomain::ReadGuard guard{ m_epochDomain };
+
+        const auto handlers{ m_handlers.load(std::memory_order_seq_cst) };
+        InvokeHandlers(guard, handlers->wildcards, message);
+
+        if (!handlers->routed.empty()) {
+            const auto routedHandlers{ handlers->routed.find(handlers->routingKeyFunction(message)) };
+            if (routedHandlers != handlers->routed.end()) {
+                InvokeHandlers(guard, routedHandlers->second, message);
+            }
         }
     }
 
-    template <typename EventHandlerType>
-    static std::function<void(const EventType&)> CreateHandler(EventHandlerType& handler)
+    static void InvokeHandlers(EpochDomain::ReadGuard& guard, const std::vector<Subscription>& subscriptions, const EventType& message)
     {
-        return [&handler](const EventType& message) { handler(message); };
+        for (const auto& subscription : subscriptions) {
+            // removed subscriptions are skipped by the generation check until the list is rebuilt
+            guard.Invoke(
+                subscription.generation,
+                [&subscription]() { return subscription.generation->load(std::memory_order_seq_cst) == subscription.subscribedGeneration; },
+                [&subscription, &message]() { subscription.delegate(message); });
+        }
+    }
+
+    void RefreshHandlers()
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        if (!m_handlersDirty.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        auto newHandlers{ new HandlerList{} };
+        newHandlers->routingKeyFunction = m_routingKeyFunction;
+        m_subscriptions.ForEach([&](const SlotHandle& handle, const Subscriber& subscriber) {
+            Subscription subscription{ subscriber.delegate, &m_subscriptions.GetGeneration(handle.index), handle.generation };
+            if (subscriber.routingKey) {
+                newHandlers->routed[*subscriber.routingKey].push_back(subscription);
+            } else {
+                newHandlers->wildcards.push_back(subscription);
+            }
+        });
+
+        m_handlersDirty.store(false, std::memory_order_relaxed);
+
+        m_epochDomain.Retire(m_handlers.exchange(newHandlers, std::memory_order_seq_cst));
+    }
+
+    static void DispatchAsyncItem(void* context, AsyncItem& item)
+    {
+        auto& self{ *static_cast<EventChannelQueue*>(context) };
+
+        std::visit([&self](auto& work) { self.DispatchAsyncWork(work); }, item);
+    }
+
+    void DispatchAsyncWork(AsyncEvent& event)
+    {
+        std::exception_ptr exception;
+        try {
+            DispatchEvent(event.message);
+        } catch (...) {
+            exception = std::current_exception();
+        }
+        m_metrics.OnAsyncCompleted();
+
+        Complete(event.tracked, exception);
+    }
+
+    void DispatchAsyncWork(AsyncBatch& batch)
+    {
+        // a failing event does not stop the rest of the batch, the first failure is reported
+        std::exception_ptr exception;
+        for (const auto& message : batch.messages) {
+            try {
+                DispatchEvent(message);
+            } catch (...) {
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+            m_metrics.OnAsyncCompleted();
+        }
+
+        Complete(batch.tracked, exception);
+    }
+
+    void Complete(const bool tracked, const std::exception_ptr& exception)
+    {
+        // failures of detached events are dropped, there is nobody to report them to
+        if (!tracked || !exception) {
+            return;
+        }
+
+        // the first failure is kept until it is reported, the later ones are dropped
+        std::scoped_lock lock{ m_asyncFailureMutex };
+
+        if (!m_asyncFailure) {
+            m_asyncFailure = exception;
+            m_hasAsyncFailure.store(true, std::memory_order_release);
+        }
     }
 
 private:
     friend class Singleton<EventChannelQueue<EventType>>;
 
 private:
-    static const inline size_t MAX_ASYNC_TASK_COUNT{ 1024 };
+    static const inline std::chrono::steady_clock::duration TIMER_RESOLUTION{ std::chrono::milliseconds{ 1 } };
+
+    EventChannelQueueManager& m_manager;
+
+    EpochDomain& m_epochDomain{ EpochDomain::Instance() };
+
+    std::mutex m_mutex;
+
+    SlotMap<Subscriber> m_subscriptions;
+
+    KeyFunction m_routingKeyFunction{ nullptr };
+
+    std::atomic<bool> m_handlersDirty{ false };
+
+    std::atomic<HandlerList*> m_handlers{ new HandlerList{} };
+
+    std::recursive_mutex m_queuedMutex;
+
+    QueuedLane m_queuedLanes[PRIORITY_COUNT];
+
+    KeyFunction m_coalescingKeyFunction{ nullptr };
+
+    std::atomic<bool> m_queuedDispatchOnCallerThread{ false };
+
+    std::atomic<bool> m_serializedDispatch{ false };
+
+    std::recursive_mutex m_dispatchMutex;
+
+    std::atomic<IPostObserver<EventType>*> m_postObserver{ nullptr };
+
+    std::mutex m_asyncFailureMutex;
+
+    // the first failure of an ASYNC handler not reported yet
+    std::exception_ptr m_asyncFailure;
+
+    std::atomic<bool> m_hasAsyncFailure{ false };
 
-    static const inline size_t THREAD_POOL_THREAD_COUNT{ 1 };
+    ChannelMetrics m_metrics;
 
-    std::recursive_mutex m_mutex;
+    // a lane keeps the async delivery ordered, the lanes are dispatched on the executor shared by all channels
+    std::vector<std::unique_ptr<Strand<AsyncItem>>> m_asyncLanes;
 
-    std::vector<std::function<void(const EventType&)>> m_handlers;
+    std::atomic<size_t> m_nextAsyncLane{ 0 };
 
-    std::vector<void*> m_originalPointers;
+    KeyFunction m_asyncKeyFunction{ nullptr };
 
-    std::deque<EventType> m_eventsToDeliver;
+    std::mutex m_timersMutex;
 
-    ThreadPool m_threadPool{ THREAD_POOL_THREAD_COUNT };
+    // created by the first delayed post
+    std::unique_ptr<TimerWheel<DelayedEvent>> m_timers;
 
-    RingBuffer<std::future<void>, MAX_ASYNC_TASK_COUNT> m_asyncTasks;
+    std::chrono::steady_clock::time_point m_timerEpoch;
 
-    std::mutex m_asyncTasksMutex;
+    std::atomic<size_t> m_pendingTimerCount{ 0 };
 };
 } // namespace worm::detail
 
@@ -3,16 +3,50 @@
 
 #include "IEventChannelQueue.h"
 #include "Singleton.h"
+#include "WorkStealingExecutor.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <functional>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <shared_mutex>
 #include <stdexcept>
+#include <thread>
 #include <vector>
 
 namespace worm::detail {
+// Limits a single queued dispatch - it stops once maxEventCount events are dispatched or the deadline has passed.
+struct DispatchBudget {
+    size_t maxEventCount{ std::numeric_limits<size_t>::max() };
+
+    std::chrono::steady_clock::time_point deadline{ std::chrono::steady_clock::time_point::max() };
+
+    static DispatchBudget ForEventCount(const size_t maxEventCount)
+    {
+        return { maxEventCount, std::chrono::steady_clock::time_point::max() };
+    }
+
+    static DispatchBudget ForDuration(const std::chrono::steady_clock::duration duration)
+    {
+        return { std::numeric_limits<size_t>::max(), std::chrono::steady_clock::now() + duration };
+    }
+};
+
 class EventChannelQueueManager final : public Singleton<EventChannelQueueManager> {
+public:
+    explicit EventChannelQueueManager(const size_t workerCount = std::max<size_t>(1, std::thread::hardware_concurrency()))
+        : Singleton<EventChannelQueueManager>()
+        , m_executor{ workerCount }
+    {
+    }
+
+    ~EventChannelQueueManager() = default;
+
 public:
     void Add(IEventChannelQueue& queue)
     {
@@ -32,13 +66,51 @@ public:
         m_eventChannelQueues.erase(it);
     }
 
+    // Due delayed events are posted first, so the due QUEUED ones are dispatched by the same call.
     void DispatchAllQueued()
     {
         std::shared_lock lock{ m_mutex };
 
+        AdvanceTimersInternal();
         DispatchAllQueuedInternal();
     }
 
+    // Dispatches the queued events until the budget runs out, higher priorities of all the channels go first.
+    // The channels take turns in slices of BUDGET_SLICE_SIZE events and the next call continues with the channel
+    // which was next in turn, so a busy channel can not starve the others. The deadline is checked between
+    // the slices. Like the unbudgeted dispatch, only the backlog a priority has when its turn comes is dispatched,
+    // events posted meanwhile (by the handlers too) are left for the next call. Always runs on the calling thread.
+    // Returns the number of dispatched events.
+    // Posting the due delayed events is not limited by the budget - a due SYNC event is dispatched right away and
+    // the time taken counts against the deadline, but not against the event count. Due QUEUED events are dispatched
+    // within the budget.
+    size_t DispatchAllQueued(const DispatchBudget& budget)
+    {
+        std::shared_lock lock{ m_mutex };
+
+        AdvanceTimersInternal();
+        return DispatchAllQueuedInternal(budget);
+    }
+
+    void AdvanceTimers()
+    {
+        std::shared_lock lock{ m_mutex };
+
+        AdvanceTimersInternal();
+    }
+
+    // Queued events of all the channels waiting for the dispatch.
+    uint64_t GetQueuedBacklog()
+    {
+        std::shared_lock lock{ m_mutex };
+
+        uint64_t count{ 0 };
+        for (const auto queue : m_eventChannelQueues) {
+            count += queue->GetQueuedCount();
+        }
+        return count;
+    }
+
     void DispatchAllAsync()
     {
         std::shared_lock lock{ m_mutex };
@@ -46,20 +118,229 @@ public:
         DispatchAllAsyncInternal();
     }
 
+    // Returns true if all the async events have been handled, never blocks. Rethrows the first unreported failure
+    // of an ASYNC handler.
+    bool PollAsync()
+    {
+        std::shared_lock lock{ m_mutex };
+
+        bool isIdle{ true };
+        for (const auto queue : m_eventChannelQueues) {
+            isIdle = queue->PollAsync() && isIdle;
+        }
+        return isIdle;
+    }
+
+    // Waits at most the timeout for the async events posted so far, returns false if some are still pending.
+    // Rethrows like PollAsync.
+    bool WaitAsync(const std::chrono::steady_clock::duration timeout)
+    {
+        const auto deadline{ std::chrono::steady_clock::now() + timeout };
+
+        std::shared_lock lock{ m_mutex };
+
+        bool isIdle{ true };
+        for (const auto queue : m_eventChannelQueues) {
+            isIdle = queue->WaitAsync(deadline) && isIdle;
+        }
+        return isIdle;
+    }
+
+    uint64_t GetPendingAsyncCount()
+    {
+        std::shared_lock lock{ m_mutex };
+
+        uint64_t count{ 0 };
+        for (const auto queue : m_eventChannelQueues) {
+            count += queue->GetPendingAsyncCount();
+        }
+        return count;
+    }
+
     void DispatchAll()
     {
         std::shared_lock lock{ m_mutex };
 
+        AdvanceTimersInternal();
         DispatchAllQueuedInternal();
         DispatchAllAsyncInternal();
     }
 
+    std::vector<ChannelMetricsSnapshot> GetMetrics()
+    {
+        std::shared_lock lock{ m_mutex };
+
+        std::vector<ChannelMetricsSnapshot> metrics;
+        metrics.reserve(m_eventChannelQueues.size());
+        for (const auto queue : m_eventChannelQueues) {
+            metrics.emplace_back(queue->GetMetrics());
+        }
+        return metrics;
+    }
+
+    // Spreads the queued dispatch of independent channels over the executor workers, the caller joins the drain
+    // and waits until all the channels are drained. Handlers of different event types then run concurrently.
+    void SetParallelQueuedDispatch(const bool enabled)
+    {
+        m_parallelQueuedDispatch.store(enabled, std::memory_order_relaxed);
+    }
+
+    WorkStealingExecutor& GetExecutor()
+    {
+        return m_executor;
+    }
+
+private:
+    struct ParallelDrain {
+        std::vector<IEventChannelQueue*> queues;
+
+        std::atomic<size_t> nextQueue{ 0 };
+
+        std::mutex mutex;
+
+        std::condition_variable doneCondition;
+
+        size_t remainingCount{ 0 };
+
+        std::exception_ptr exception;
+    };
+
 private:
+    void AdvanceTimersInternal()
+    {
+        const auto now{ std::chrono::steady_clock::now() };
+        for (const auto queue : m_eventChannelQueues) {
+            queue->AdvanceTimers(now);
+        }
+    }
+
     void DispatchAllQueuedInternal()
     {
-        for (size_t i = 0; i < m_eventChannelQueues.size(); ++i) {
-            auto& queue{ m_eventChannelQueues[i] };
-            queue->DispatchAllQueued();
+        if (m_parallelQueuedDispatch.load(std::memory_order_relaxed) && m_eventChannelQueues.size() > 1) {
+            DispatchAllQueuedParallel();
+            return;
+        }
+
+        // higher priorities of all the channels go first
+        for (size_t priority = PRIORITY_COUNT; priority-- > 0;) {
+            for (size_t i = 0; i < m_eventChannelQueues.size(); ++i) {
+                auto& queue{ m_eventChannelQueues[i] };
+                queue->DispatchQueued(static_cast<Priority>(priority));
+            }
+        }
+    }
+
+    size_t DispatchAllQueuedInternal(const DispatchBudget& budget)
+    {
+        const auto queueCount{ m_eventChannelQueues.size() };
+
+        // events of the current priority each channel has left to dispatch
+        std::vector<uint64_t> backlogs(queueCount);
+
+        size_t count{ 0 };
+        for (size_t priority = PRIORITY_COUNT; priority-- > 0;) {
+            for (size_t i = 0; i < queueCount; ++i) {
+                backlogs[i] = m_eventChannelQueues[i]->GetQueuedCount(static_cast<Priority>(priority));
+            }
+
+            for (bool pending{ true }; pending;) {
+                pending = false;
+                for (size_t i = 0; i < queueCount; ++i) {
+                    const auto index{ m_nextBudgetQueue.load(std::memory_order_relaxed) % queueCount };
+                    auto& backlog{ backlogs[index] };
+                    if (backlog == 0) {
+                        m_nextBudgetQueue.store(index + 1, std::memory_order_relaxed);
+                        continue;
+                    }
+
+                    if (count == budget.maxEventCount || (budget.deadline != std::chrono::steady_clock::time_point::max() && std::chrono::steady_clock::now() >= budget.deadline)) {
+                        return count;
+                    }
+
+                    const auto sliceSize{ static_cast<size_t>(std::min<uint64_t>(backlog, std::min(BUDGET_SLICE_SIZE, budget.maxEventCount - count))) };
+                    m_nextBudgetQueue.store(index + 1, std::memory_order_relaxed);
+                    const auto sliceCount{ m_eventChannelQueues[index]->DispatchQueued(static_cast<Priority>(priority), sliceSize) };
+                    count += sliceCount;
+
+                    // a short slice means the channel ran out of the events queued before it was called
+                    backlog = sliceCount < sliceSize ? 0 : backlog - sliceCount;
+                    pending = pending || backlog > 0;
+                }
+            }
+        }
+        return count;
+    }
+
+    // Every channel dispatches its higher priorities first, the channels themselves are not ordered.
+    void DispatchAllQueuedParallel()
+    {
+        // the state is shared with the tasks which might start only after the caller is done
+        auto drain{ std::make_shared<ParallelDrain>() };
+
+        std::vector<IEventChannelQueue*> callerQueues;
+        for (const auto queue : m_eventChannelQueues) {
+            if (queue->IsQueuedDispatchOnCallerThread()) {
+                callerQueues.push_back(queue);
+            } else {
+                drain->queues.push_back(queue);
+            }
+        }
+        drain->remainingCount = drain->queues.size();
+
+        const auto taskCount{ std::min(m_executor.GetWorkerCount(), drain->queues.size()) };
+        for (size_t i = 0; i < taskCount; ++i) {
+            m_executor.Submit({ &EventChannelQueueManager::RunParallelDrain, new std::shared_ptr<ParallelDrain>{ drain } });
+        }
+
+        std::exception_ptr exception;
+        try {
+            for (const auto queue : callerQueues) {
+                queue->DispatchAllQueued();
+            }
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        // help with the rest and wait for the queues taken by the workers
+        DrainQueues(*drain);
+
+        std::unique_lock lock{ drain->mutex };
+
+        drain->doneCondition.wait(lock, [&drain]() { return drain->remainingCount == 0; });
+
+        if (!exception) {
+            exception = drain->exception;
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    static void RunParallelDrain(void* context)
+    {
+        std::unique_ptr<std::shared_ptr<ParallelDrain>> drain{ static_cast<std::shared_ptr<ParallelDrain>*>(context) };
+
+        DrainQueues(**drain);
+    }
+
+    static void DrainQueues(ParallelDrain& drain)
+    {
+        for (auto index{ drain.nextQueue.fetch_add(1) }; index < drain.queues.size(); index = drain.nextQueue.fetch_add(1)) {
+            std::exception_ptr exception;
+            try {
+                drain.queues[index]->DispatchAllQueued();
+            } catch (...) {
+                exception = std::current_exception();
+            }
+
+            std::scoped_lock lock{ drain.mutex };
+
+            if (exception && !drain.exception) {
+                drain.exception = exception;
+            }
+            if (--drain.remainingCount == 0) {
+                drain.doneCondition.notify_all();
+            }
         }
     }
 
@@ -71,11 +352,6 @@ private:
         }
     }
 
-private:
-    EventChannelQueueManager() = default;
-
-    ~EventChannelQueueManager() = default;
-
 private:
     EventChannelQueueManager(EventChannelQueueManager&& other) = delete;
 
@@ -88,10 +364,20 @@ private:
 private:
     friend class Singleton<EventChannelQueueManager>;
 
+private:
+    static const inline size_t BUDGET_SLICE_SIZE{ 16 };
+
 private:
     std::shared_mutex m_mutex;
 
     std::vector<IEventChannelQueue*> m_eventChannelQueues;
+
+    std::atomic<bool> m_parallelQueuedDispatch{ false };
+
+    // the channel to continue a budgeted dispatch with
+    std::atomic<size_t> m_nextBudgetQueue{ 0 };
+
+    WorkStealingExecutor m_executor;
 };
 } // namespace worm::detail
 
@@ -0,0 +1,247 @@
+#ifndef __WH_EVENT_LOG_H__
+#define __WH_EVENT_LOG_H__
+
+#if defined(__unix__) || defined(__APPLE__)
+#define WH_HAS_MAPPED_FILES 1
+#else
+#define WH_HAS_MAPPED_FILES 0
+#endif
+
+#if WH_HAS_MAPPED_FILES
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+namespace worm::detail {
+// Binary log of timestamped, type-tagged records in a memory-mapped file:
+//  file header - magic, version
+//  record      - payload size, type tag, timestamp, flags, payload padded to RECORD_ALIGNMENT
+// A zero payload size ends the log.
+struct EventLogFormat {
+    static const inline uint64_t MAGIC{ 0x31474f4c45485721 };
+
+    static const inline uint32_t VERSION{ 2 };
+
+    static const inline size_t RECORD_ALIGNMENT{ 8 };
+
+    struct FileHeader {
+        uint64_t magic;
+
+        uint32_t version;
+
+        uint32_t reserved;
+    };
+
+    struct RecordHeader {
+        // written last, the record is complete once it is set
+        std::atomic<uint32_t> payloadSize;
+
+        uint32_t typeTag;
+
+        uint64_t timestamp;
+
+        // meaning defined by the writer
+        uint32_t flags;
+
+        uint32_t reserved;
+    };
+
+    static size_t GetRecordSize(const size_t payloadSize)
+    {
+        return sizeof(RecordHeader) + (payloadSize + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+    }
+};
+
+// Appends records to a file of a fixed capacity, records which do not fit are dropped. Any number of threads may
+// append concurrently - a record is reserved by a single atomic add and copied into the mapping.
+// The file is truncated to the appended records when the writer is destroyed.
+class EventLogWriter final {
+public:
+    EventLogWriter(const std::string& path, const size_t capacity)
+        : m_capacity{ sizeof(EventLogFormat::FileHeader) + capacity }
+    {
+        m_fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+        if (m_fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Could not create event log " + path);
+        }
+
+        // the file is zero filled, so the log always ends at a record not yet written
+        if (::ftruncate(m_fd, static_cast<off_t>(m_capacity)) != 0) {
+            const auto error{ errno };
+            ::close(m_fd);
+            throw std::system_error(error, std::generic_category(), "Could not resize event log " + path);
+        }
+
+        const auto memory{ ::mmap(nullptr, m_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0) };
+        if (memory == MAP_FAILED) {
+            const auto error{ errno };
+            ::close(m_fd);
+            throw std::system_error(error, std::generic_category(), "Could not map event log " + path);
+        }
+        m_memory = static_cast<unsigned char*>(memory);
+
+        new (m_memory) EventLogFormat::FileHeader{ EventLogFormat::MAGIC, EventLogFormat::VERSION, 0 };
+    }
+
+    ~EventLogWriter()
+    {
+        const auto size{ std::min(m_offset.load(std::memory_order_acquire), m_capacity) };
+        ::munmap(m_memory, m_capacity);
+        [[maybe_unused]] const auto result{ ::ftruncate(m_fd, static_cast<off_t>(size)) };
+        ::close(m_fd);
+    }
+
+public:
+    // Returns false if the log is full.
+    bool Append(const uint32_t typeTag, const uint64_t timestamp, const void* payload, const uint32_t payloadSize, const uint32_t flags = 0)
+    {
+        const auto recordSize{ EventLogFormat::GetRecordSize(payloadSize) };
+        const auto offset{ m_offset.fetch_add(recordSize, std::memory_order_relaxed) };
+        if (offset + recordSize > m_capacity) {
+            m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const auto header{ new (m_memory + offset) EventLogFormat::RecordHeader{ { 0 }, typeTag, timestamp, flags, 0 } };
+        std::memcpy(m_memory + offset + sizeof(EventLogFormat::RecordHeader), payload, payloadSize);
+        header->payloadSize.store(payloadSize, std::memory_order_release);
+
+        m_recordCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    uint64_t GetRecordCount() const
+    {
+        return m_recordCount.load(std::memory_order_relaxed);
+    }
+
+    uint64_t GetDroppedCount() const
+    {
+        return m_droppedCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    EventLogWriter(const EventLogWriter& other) = delete;
+
+    EventLogWriter& operator=(const EventLogWriter& other) = delete;
+
+    EventLogWriter(EventLogWriter&& other) = delete;
+
+    EventLogWriter& operator=(EventLogWriter&& other) = delete;
+
+private:
+    const size_t m_capacity;
+
+    int m_fd{ -1 };
+
+    unsigned char* m_memory{ nullptr };
+
+    alignas(64) std::atomic<size_t> m_offset{ sizeof(EventLogFormat::FileHeader) };
+
+    alignas(64) std::atomic<uint64_t> m_recordCount{ 0 };
+
+    std::atomic<uint64_t> m_droppedCount{ 0 };
+};
+
+// Reads the records of a complete log in the appended order.
+class EventLogReader final {
+public:
+    struct Record {
+        uint32_t typeTag;
+
+        uint64_t timestamp;
+
+        const unsigned char* payload;
+
+        uint32_t payloadSize;
+
+        uint32_t flags;
+    };
+
+public:
+    explicit EventLogReader(const std::string& path)
+    {
+        const auto fd{ ::open(path.c_str(), O_RDONLY) };
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Could not open event log " + path);
+        }
+
+        struct stat status { };
+        if (::fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(EventLogFormat::FileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("File " + path + " is not an event log");
+        }
+        m_size = static_cast<size_t>(status.st_size);
+
+        const auto memory{ ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0) };
+        const auto error{ errno };
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), "Could not map event log " + path);
+        }
+        m_memory = static_cast<const unsigned char*>(memory);
+
+        EventLogFormat::FileHeader header;
+        std::memcpy(&header, m_memory, sizeof(header));
+        if (header.magic != EventLogFormat::MAGIC || header.version != EventLogFormat::VERSION) {
+            ::munmap(const_cast<unsigned char*>(m_memory), m_size);
+            throw std::runtime_error("File " + path + " is not an event log");
+        }
+    }
+
+    ~EventLogReader()
+    {
+        ::munmap(const_cast<unsigned char*>(m_memory), m_size);
+    }
+
+public:
+    template <typename ConsumerType>
+    size_t ForEach(ConsumerType&& consumer) const
+    {
+        size_t count{ 0 };
+        for (auto offset{ sizeof(EventLogFormat::FileHeader) }; offset + sizeof(EventLogFormat::RecordHeader) <= m_size;) {
+            const auto header{ std::launder(reinterpret_cast<const EventLogFormat::RecordHeader*>(m_memory + offset)) };
+            const auto payloadSize{ header->payloadSize.load(std::memory_order_acquire) };
+            const auto recordSize{ EventLogFormat::GetRecordSize(payloadSize) };
+            if (payloadSize == 0 || offset + recordSize > m_size) {
+                break;
+            }
+
+            consumer(Record{ header->typeTag, header->timestamp, m_memory + offset + sizeof(EventLogFormat::RecordHeader), payloadSize, header->flags });
+            offset += recordSize;
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    EventLogReader(const EventLogReader& other) = delete;
+
+    EventLogReader& operator=(const EventLogReader& other) = delete;
+
+    EventLogReader(EventLogReader&& other) = delete;
+
+    EventLogReader& operator=(EventLogReader&& other) = delete;
+
+private:
+    size_t m_size{ 0 };
+
+    const unsigned char* m_memory{ nullptr };
+};
+} // namespace worm::detail
+
+#endif
+
+#endif
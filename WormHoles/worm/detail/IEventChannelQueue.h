@@ -1,13 +1,66 @@
 #ifndef __WH_IEVENT_CHANNEL_QUEUE_H__
 #define __WH_IEVENT_CHANNEL_QUEUE_H__
 
+#include "ChannelMetrics.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
 namespace worm::detail {
+enum class DispatchType {
+    SYNC,
+    ASYNC,
+    QUEUED,
+    ASYNC_DETACHED
+};
+
+// Queued events of a higher priority are dispatched first.
+enum class Priority {
+    LOW,
+    NORMAL,
+    HIGH,
+    CRITICAL
+};
+
+static const inline size_t PRIORITY_COUNT{ 4 };
+
+static_assert(ChannelMetrics::QUEUED_LANE_COUNT == PRIORITY_COUNT, "Queued events are counted per priority");
+
 class IEventChannelQueue {
 public:
     virtual void DispatchAllQueued() = 0;
 
+    virtual void DispatchQueued(const Priority priority) = 0;
+
+    // Dispatches at most maxCount queued events of the priority, returns the number of dispatched events.
+    virtual size_t DispatchQueued(const Priority priority, const size_t maxCount) = 0;
+
+    // Queued events waiting for the dispatch.
+    virtual uint64_t GetQueuedCount() const = 0;
+
+    virtual uint64_t GetQueuedCount(const Priority priority) const = 0;
+
+    // Posts the delayed events which are due.
+    virtual void AdvanceTimers(const std::chrono::steady_clock::time_point now) = 0;
+
+    // Blocks until the async events posted so far are handled, rethrows the first unreported failure of an ASYNC handler.
     virtual void DispatchAllAsync() = 0;
 
+    // Never blocks, returns true if all the async events have been handled. Rethrows like DispatchAllAsync.
+    virtual bool PollAsync() = 0;
+
+    // Returns false if the async events posted so far are not handled by the deadline. Rethrows like DispatchAllAsync.
+    virtual bool WaitAsync(const std::chrono::steady_clock::time_point deadline) = 0;
+
+    // ASYNC and ASYNC_DETACHED events not handled yet.
+    virtual uint64_t GetPendingAsyncCount() const = 0;
+
+    virtual ChannelMetricsSnapshot GetMetrics() const = 0;
+
+    // Queued events of the channel are dispatched on the thread calling DispatchAllQueued even with the parallel drain.
+    virtual bool IsQueuedDispatchOnCallerThread() const = 0;
+
 public:
     virtual ~IEventChannelQueue() = default;
 };
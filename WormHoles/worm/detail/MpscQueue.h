@@ -0,0 +1,255 @@
+#ifndef __WH_MPSC_QUEUE_H__
+#define __WH_MPSC_QUEUE_H__
+
+#include "Construct.h"
+#include "CycleArena.h"
+
+#include <atomic>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace worm::detail {
+template <typename ItemType>
+class MpscQueue;
+
+// Called by the consumer right before it re-inserts the stub behind the last item, the point where a racing push
+// lands in front of the stub. Does nothing, tests specialize it to inject the push.
+template <typename ItemType>
+struct MpscQueueStubHook {
+    static void BeforeStubPush(MpscQueue<ItemType>&)
+    {
+    }
+};
+
+// Intrusive multi-producer/single-consumer queue (D. Vyukov).
+// Producers are wait-free - one exchange per push. Only one thread may consume at a time.
+template <typename ItemType>
+class MpscQueue final {
+private:
+    struct NodeBase {
+        std::atomic<NodeBase*> next{ nullptr };
+    };
+
+    struct Node final : NodeBase {
+        template <typename... Args>
+        explicit Node(Args&&... args)
+            : value(Construct<ItemType>(std::forward<Args>(args)...))
+        {
+        }
+
+        ItemType value;
+    };
+
+public:
+    MpscQueue() = default;
+
+    ~MpscQueue()
+    {
+        while (auto node{ PopNode() }) {
+            DestroyNode(node);
+        }
+    }
+
+public:
+    void Push(const ItemType& item)
+    {
+        Emplace(item);
+    }
+
+    void Push(ItemType&& item)
+    {
+        Emplace(std::move(item));
+    }
+
+    template <typename... Args>
+    void Emplace(Args&&... args)
+    {
+        auto node{ CreateNode(std::forward<Args>(args)...) };
+        PushChain(node, node);
+    }
+
+    // The whole range becomes visible to the consumer at once, it is published by a single exchange.
+    template <typename IteratorType>
+    void PushRange(IteratorType first, IteratorType last)
+    {
+        if (first == last) {
+            return;
+        }
+
+        auto head{ CreateNode(*first) };
+        NodeBase* tail{ head };
+        try {
+            for (++first; first != last; ++first) {
+                auto node{ CreateNode(*first) };
+                tail->next.store(node, std::memory_order_relaxed);
+                tail = node;
+            }
+        } catch (...) {
+            for (NodeBase* node{ head }; node;) {
+                auto next{ node->next.load(std::memory_order_relaxed) };
+                DestroyNode(static_cast<Node*>(node));
+                node = next;
+            }
+            throw;
+        }
+
+        PushChain(head, tail);
+    }
+
+    // Consumes items pushed before the call, items pushed concurrently are left for the next call.
+    template <typename ConsumerType>
+    size_t ConsumeAll(ConsumerType&& consumer)
+    {
+        return Consume(std::numeric_limits<size_t>::max(), consumer);
+    }
+
+    // Consumes at most maxCount items pushed before the call, the rest is left for the next call.
+    template <typename ConsumerType>
+    size_t Consume(const size_t maxCount, ConsumerType&& consumer)
+    {
+        const NodeBase* last{ m_head.load(std::memory_order_acquire) };
+
+        size_t count{ 0 };
+        while (count < maxCount) {
+            // the stub as the head still might follow items pushed while it was re-inserted, they all come before it
+            if (last == &m_stub && m_tail.load(std::memory_order_relaxed) == &m_stub) {
+                break;
+            }
+
+            const auto node{ PopNode() };
+            if (!node) {
+                break;
+            }
+
+            const NodeGuard guard{ *this, node };
+            ++count;
+            consumer(node->value);
+            if (node == last) {
+                break;
+            }
+        }
+        return count;
+    }
+
+    // Decided on the consumer side, the head is the stub also when a racing push landed in front of it.
+    bool IsEmpty() const
+    {
+        return m_tail.load(std::memory_order_acquire) == &m_stub && !m_stub.next.load(std::memory_order_acquire);
+    }
+
+    // Allocates the nodes from the cycle arena of the producing thread instead of the heap.
+    // Must not be changed while there are queued items.
+    void SetCycleArena(const bool enabled)
+    {
+        m_cycleArena = enabled;
+    }
+
+private:
+    struct NodeGuard {
+        ~NodeGuard()
+        {
+            queue.DestroyNode(node);
+        }
+
+        MpscQueue& queue;
+
+        Node* node;
+    };
+
+private:
+    bool UsesCycleArena() const
+    {
+        return m_cycleArena && alignof(Node) <= CycleArena::ALIGNMENT;
+    }
+
+    template <typename... Args>
+    Node* CreateNode(Args&&... args)
+    {
+        if (!UsesCycleArena()) {
+            return new Node(std::forward<Args>(args)...);
+        }
+
+        auto memory{ CycleArena::Allocate(sizeof(Node)) };
+        try {
+            return new (memory) Node(std::forward<Args>(args)...);
+        } catch (...) {
+            CycleArena::Deallocate(memory);
+            throw;
+        }
+    }
+
+    void DestroyNode(Node* node)
+    {
+        if (!UsesCycleArena()) {
+            delete node;
+            return;
+        }
+
+        node->~Node();
+        CycleArena::Deallocate(node);
+    }
+
+    void PushChain(NodeBase* first, NodeBase* last)
+    {
+        last->next.store(nullptr, std::memory_order_relaxed);
+        NodeBase* prev{ m_head.exchange(last, std::memory_order_acq_rel) };
+        prev->next.store(first, std::memory_order_release);
+    }
+
+    Node* PopNode()
+    {
+        NodeBase* tail{ m_tail.load(std::memory_order_relaxed) };
+        NodeBase* next{ tail->next.load(std::memory_order_acquire) };
+        if (tail == &m_stub) {
+            if (!next) {
+                return nullptr;
+            }
+            m_tail.store(next, std::memory_order_release);
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            m_tail.store(next, std::memory_order_release);
+            return static_cast<Node*>(tail);
+        }
+
+        // a producer is in the middle of a push -> try again on the next call
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+
+        MpscQueueStubHook<ItemType>::BeforeStubPush(*this);
+        PushChain(&m_stub, &m_stub);
+
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail.store(next, std::memory_order_release);
+            return static_cast<Node*>(tail);
+        }
+        return nullptr;
+    }
+
+private:
+    MpscQueue(const MpscQueue& other) = delete;
+
+    MpscQueue& operator=(const MpscQueue& other) = delete;
+
+    MpscQueue(MpscQueue&& other) = delete;
+
+    MpscQueue& operator=(MpscQueue&& other) = delete;
+
+private:
+    bool m_cycleArena{ false };
+
+    NodeBase m_stub;
+
+    alignas(64) std::atomic<NodeBase*> m_head{ &m_stub };
+
+    // written by the consumer only, read by IsEmpty
+    alignas(64) std::atomic<NodeBase*> m_tail{ &m_stub };
+};
+} // namespace worm::detail
+
+#endif
@@ -0,0 +1,383 @@
+#ifndef __WH_PRODUCER_BUFFERED_QUEUE_H__
+#define __WH_PRODUCER_BUFFERED_QUEUE_H__
+
+#include "Construct.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace worm::detail {
+// Multi-producer/single-consumer queue where every producer thread pushes into its own single-producer buffer,
+// so producers never write to a shared cache line. Items of one producer are consumed in the order they were pushed,
+// items of different producers are not ordered. Buffers of exited threads are reused by new ones.
+// Only one thread may consume at a time.
+template <typename ItemType>
+class ProducerBufferedQueue final {
+private:
+    static const inline size_t CHUNK_SIZE{ 256 };
+
+    struct Chunk {
+        ItemType* Get(const size_t index)
+        {
+            return std::launder(reinterpret_cast<ItemType*>(&slots[index]));
+        }
+
+        std::aligned_storage_t<sizeof(ItemType), alignof(ItemType)> slots[CHUNK_SIZE];
+
+        std::atomic<Chunk*> next{ nullptr };
+    };
+
+    class Buffer final {
+    public:
+        Buffer()
+            : m_tail{ new Chunk{} }
+            , m_head{ m_tail }
+        {
+        }
+
+        ~Buffer()
+        {
+            for (auto count{ m_pushedCount.load(std::memory_order_acquire) }; m_consumedCount < count; ++m_consumedCount) {
+                PopItem();
+            }
+
+            for (auto chunk{ m_head }; chunk;) {
+                const auto next{ chunk->next.load(std::memory_order_relaxed) };
+                delete chunk;
+                chunk = next;
+            }
+            delete m_spareChunk.load(std::memory_order_relaxed);
+        }
+
+    public:
+        template <typename... Args>
+        void Emplace(Args&&... args)
+        {
+            EmplaceItem(std::forward<Args>(args)...);
+            m_pushedCount.store(++m_pushedLocalCount, std::memory_order_release);
+        }
+
+        // The whole range becomes visible to the consumer at once.
+        template <typename IteratorType>
+        void PushRange(IteratorType first, IteratorType last)
+        {
+            const auto publishedCount{ m_pushedLocalCount };
+            try {
+                for (; first != last; ++first) {
+                    EmplaceItem(*first);
+                    ++m_pushedLocalCount;
+                }
+            } catch (...) {
+                // publish what is already constructed, the items can not be taken back from the chunks
+                m_pushedCount.store(m_pushedLocalCount, std::memory_order_release);
+                throw;
+            }
+
+            if (m_pushedLocalCount != publishedCount) {
+                m_pushedCount.store(m_pushedLocalCount, std::memory_order_release);
+            }
+        }
+
+        template <typename ConsumerType>
+        size_t Consume(const size_t maxCount, ConsumerType& consumer)
+        {
+            const auto pushedCount{ m_pushedCount.load(std::memory_order_acquire) };
+            const auto count{ pushedCount - m_consumedCount > maxCount ? m_consumedCount + maxCount : pushedCount };
+            const auto consumedCount{ m_consumedCount };
+            while (m_consumedCount < count) {
+                struct PopGuard {
+                    ~PopGuard()
+                    {
+                        buffer.PopItem();
+                        ++buffer.m_consumedCount;
+                    }
+
+                    Buffer& buffer;
+                } guard{ *this };
+
+                if (m_headIndex == CHUNK_SIZE) {
+                    NextHeadChunk();
+                }
+                consumer(*m_head->Get(m_headIndex));
+            }
+            return static_cast<size_t>(count - consumedCount);
+        }
+
+        bool IsEmpty() const
+        {
+            return m_pushedCount.load(std::memory_order_acquire) == m_consumedCount;
+        }
+
+        bool TryAcquire()
+        {
+            bool used{ false };
+            return !m_used.load(std::memory_order_relaxed) && m_used.compare_exchange_strong(used, true, std::memory_order_acquire);
+        }
+
+        void Release()
+        {
+            m_used.store(false, std::memory_order_release);
+        }
+
+    public:
+        // immutable once the buffer is published
+        Buffer* next{ nullptr };
+
+    private:
+        template <typename... Args>
+        void EmplaceItem(Args&&... args)
+        {
+            if (m_tailIndex == CHUNK_SIZE) {
+                auto chunk{ m_spareChunk.exchange(nullptr, std::memory_order_acquire) };
+                if (!chunk) {
+                    chunk = new Chunk{};
+                }
+                chunk->next.store(nullptr, std::memory_order_relaxed);
+                m_tail->next.store(chunk, std::memory_order_relaxed);
+                m_tail = chunk;
+                m_tailIndex = 0;
+            }
+
+            new (&m_tail->slots[m_tailIndex]) ItemType(Construct<ItemType>(std::forward<Args>(args)...));
+            ++m_tailIndex;
+        }
+
+        // consumer only
+        void NextHeadChunk()
+        {
+            const auto chunk{ m_head };
+            m_head = chunk->next.load(std::memory_order_relaxed);
+            m_headIndex = 0;
+
+            delete m_spareChunk.exchange(chunk, std::memory_order_release);
+        }
+
+        void PopItem()
+        {
+            if (m_headIndex == CHUNK_SIZE) {
+                NextHeadChunk();
+            }
+            m_head->Get(m_headIndex)->~ItemType();
+            ++m_headIndex;
+        }
+
+    private:
+        Buffer(const Buffer& other) = delete;
+
+        Buffer& operator=(const Buffer& other) = delete;
+
+        Buffer(Buffer&& other) = delete;
+
+        Buffer& operator=(Buffer&& other) = delete;
+
+    private:
+        // producer side
+        Chunk* m_tail;
+
+        size_t m_tailIndex{ 0 };
+
+        uint64_t m_pushedLocalCount{ 0 };
+
+        alignas(64) std::atomic<uint64_t> m_pushedCount{ 0 };
+
+        // consumer side
+        alignas(64) Chunk* m_head;
+
+        size_t m_headIndex{ 0 };
+
+        uint64_t m_consumedCount{ 0 };
+
+        // a consumed chunk waiting for the producer
+        alignas(64) std::atomic<Chunk*> m_spareChunk{ nullptr };
+
+        std::atomic<bool> m_used{ true };
+    };
+
+    // Buffers of the calling thread, the buffers are shared with the queues so they outlive whichever ends first.
+    class ThreadBuffers final {
+    public:
+        ThreadBuffers() = default;
+
+        ~ThreadBuffers()
+        {
+            for (const auto& entry : m_entries) {
+                entry.buffer->Release();
+            }
+        }
+
+    public:
+        Buffer* Find(const uint64_t queueId) const
+        {
+            for (const auto& entry : m_entries) {
+                if (entry.queueId == queueId) {
+                    return entry.buffer.get();
+                }
+            }
+            return nullptr;
+        }
+
+        void Add(const uint64_t queueId, std::shared_ptr<Buffer> buffer)
+        {
+            // drop the buffers of destroyed queues
+            m_entries.erase(std::remove_if(m_entries.begin(), m_entries.end(), [](const Entry& entry) { return entry.buffer.use_count() == 1; }), m_entries.end());
+
+            m_entries.push_back({ queueId, std::move(buffer) });
+        }
+
+    private:
+        ThreadBuffers(const ThreadBuffers& other) = delete;
+
+        ThreadBuffers& operator=(const ThreadBuffers& other) = delete;
+
+        ThreadBuffers(ThreadBuffers&& other) = delete;
+
+        ThreadBuffers& operator=(ThreadBuffers&& other) = delete;
+
+    private:
+        struct Entry {
+            uint64_t queueId;
+
+            std::shared_ptr<Buffer> buffer;
+        };
+
+        std::vector<Entry> m_entries;
+    };
+
+public:
+    ProducerBufferedQueue() = default;
+
+    ~ProducerBufferedQueue() = default;
+
+public:
+    template <typename... Args>
+    void Emplace(Args&&... args)
+    {
+        GetThreadBuffer().Emplace(std::forward<Args>(args)...);
+    }
+
+    template <typename IteratorType>
+    void PushRange(IteratorType first, IteratorType last)
+    {
+        GetThreadBuffer().PushRange(first, last);
+    }
+
+    // Consumes items pushed before the call, the producer buffers are consumed one after another.
+    template <typename ConsumerType>
+    size_t ConsumeAll(ConsumerType&& consumer)
+    {
+        return Consume(std::numeric_limits<size_t>::max(), consumer);
+    }
+
+    // Consumes at most maxCount items, the next call continues with the producer buffer where this one stopped.
+    template <typename ConsumerType>
+    size_t Consume(const size_t maxCount, ConsumerType&& consumer)
+    {
+        const auto first{ m_buffers.load(std::memory_order_acquire) };
+        const auto start{ m_nextBuffer ? m_nextBuffer : first };
+        m_nextBuffer = nullptr;
+
+        size_t count{ 0 };
+        for (auto buffer{ start }; buffer;) {
+            if (count == maxCount) {
+                m_nextBuffer = buffer;
+                break;
+            }
+
+            count += buffer->Consume(maxCount - count, consumer);
+
+            buffer = buffer->next ? buffer->next : first;
+            if (buffer == start) {
+                break;
+            }
+        }
+        return count;
+    }
+
+    bool IsEmpty() const
+    {
+        for (auto buffer{ m_buffers.load(std::memory_order_acquire) }; buffer; buffer = buffer->next) {
+            if (!buffer->IsEmpty()) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t GetBufferCount() const
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        return m_ownedBuffers.size();
+    }
+
+private:
+    // function-local, GCC 12 clashes the guards of several inline thread_local members with dynamic initialization
+    static ThreadBuffers& GetThreadBuffers()
+    {
+        static thread_local ThreadBuffers threadBuffers;
+        return threadBuffers;
+    }
+
+    Buffer& GetThreadBuffer()
+    {
+        if (const auto buffer{ GetThreadBuffers().Find(m_id) }) {
+            return *buffer;
+        }
+        return RegisterThreadBuffer();
+    }
+
+    Buffer& RegisterThreadBuffer()
+    {
+        std::scoped_lock lock{ m_mutex };
+
+        // reuse a buffer of an exited thread
+        for (const auto& buffer : m_ownedBuffers) {
+            if (buffer->TryAcquire()) {
+                GetThreadBuffers().Add(m_id, buffer);
+                return *buffer;
+            }
+        }
+
+        auto buffer{ std::make_shared<Buffer>() };
+        buffer->next = m_buffers.load(std::memory_order_relaxed);
+        m_buffers.store(buffer.get(), std::memory_order_release);
+        m_ownedBuffers.push_back(buffer);
+        GetThreadBuffers().Add(m_id, buffer);
+        return *buffer;
+    }
+
+private:
+    ProducerBufferedQueue(const ProducerBufferedQueue& other) = delete;
+
+    ProducerBufferedQueue& operator=(const ProducerBufferedQueue& other) = delete;
+
+    ProducerBufferedQueue(ProducerBufferedQueue&& other) = delete;
+
+    ProducerBufferedQueue& operator=(ProducerBufferedQueue&& other) = delete;
+
+private:
+    static inline std::atomic<uint64_t> s_nextId{ 0 };
+
+    // unique for the whole process, so a thread never mistakes a buffer of a destroyed queue for its own
+    const uint64_t m_id{ s_nextId.fetch_add(1, std::memory_order_relaxed) };
+
+    mutable std::mutex m_mutex;
+
+    std::atomic<Buffer*> m_buffers{ nullptr };
+
+    // consumer only, the buffer to resume a limited Consume with
+    Buffer* m_nextBuffer{ nullptr };
+
+    std::vector<std::shared_ptr<Buffer>> m_ownedBuffers;
+};
+} // namespace worm::detail
+
+#endif
@@ -3,11 +3,23 @@
 
 #include <array>
 #include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 namespace worm::detail {
 
+// BufferSize of 0 makes the capacity a runtime parameter, the storage is still allocated once up front.
 template <typename EventType, size_t BufferSize = 1024>
 class RingBuffer {
+public:
+    RingBuffer() = default;
+
+    explicit RingBuffer(const size_t capacity)
+        : m_buffer(capacity)
+    {
+        static_assert(BufferSize == 0, "Only a runtime sized RingBuffer can be constructed with a capacity");
+    }
+
 public:
     void Push(const EventType& item)
     {
@@ -15,7 +27,7 @@ public:
             throw std::runtime_error("RingBuffer overflow");
         }
         m_buffer[m_tail] = item;
-        m_tail = (m_tail + 1) % BufferSize;
+        m_tail = (m_tail + 1) % Capacity();
         ++m_size;
     }
 
@@ -25,7 +37,7 @@ public:
             throw std::runtime_error("RingBuffer overflow");
         }
         m_buffer[m_tail] = std::move(item);
-        m_tail = (m_tail + 1) % BufferSize;
+        m_tail = (m_tail + 1) % Capacity();
         ++m_size;
     }
 
@@ -35,7 +47,7 @@ public:
             throw std::runtime_error("RingBuffer underflow");
         }
         EventType item = m_buffer[m_head];
-        m_head = (m_head + 1) % BufferSize;
+        m_head = (m_head + 1) % Capacity();
         --m_size;
         return item;
     }
@@ -46,11 +58,43 @@ public:
             throw std::runtime_error("RingBuffer underflow");
         }
         EventType&& item = std::move(m_buffer[m_head]);
-        m_head = (m_head + 1) % BufferSize;
+        m_head = (m_head + 1) % Capacity();
         --m_size;
         return std::move(item);
     }
 
+    // In-place access for items which are not assignable - construct the item in PeekTail() and then CommitTail().
+    EventType& PeekTail()
+    {
+        if (IsFull()) {
+            throw std::runtime_error("RingBuffer overflow");
+        }
+        return m_buffer[m_tail];
+    }
+
+    void CommitTail()
+    {
+        m_tail = (m_tail + 1) % Capacity();
+        ++m_size;
+    }
+
+    EventType& Front()
+    {
+        if (IsEmpty()) {
+            throw std::runtime_error("RingBuffer underflow");
+        }
+        return m_buffer[m_head];
+    }
+
+    void PopFront()
+    {
+        if (IsEmpty()) {
+            throw std::runtime_error("RingBuffer underflow");
+        }
+        m_head = (m_head + 1) % Capacity();
+        --m_size;
+    }
+
     bool IsEmpty() const
     {
         return m_size == 0;
@@ -58,7 +102,7 @@ public:
 
     bool IsFull() const
     {
-        return m_size == BufferSize;
+        return m_size == Capacity();
     }
 
     size_t Size() const
@@ -66,6 +110,11 @@ public:
         return m_size;
     }
 
+    size_t Capacity() const
+    {
+        return m_buffer.size();
+    }
+
     void Clear()
     {
         m_head = 0;
@@ -74,7 +123,9 @@ public:
     }
 
 private:
-    std::array<EventType, BufferSize> m_buffer{};
+    using StorageType = std::conditional_t<BufferSize == 0, std::vector<EventType>, std::array<EventType, BufferSize>>;
+
+    StorageType m_buffer{};
     size_t m_head{ 0 };
     size_t m_tail{ 0 };
     size_t m_size{ 0 };
@@ -0,0 +1,253 @@
+#ifndef __WH_SHARED_MEMORY_RING_H__
+#define __WH_SHARED_MEMORY_RING_H__
+
+#if defined(__unix__) || defined(__APPLE__)
+#define WH_HAS_SHARED_MEMORY 1
+#else
+#define WH_HAS_SHARED_MEMORY 0
+#endif
+
+#if WH_HAS_SHARED_MEMORY
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+namespace worm::detail {
+// Fixed-capacity multi-producer/single-consumer ring of trivially copyable items in a named POSIX shared memory
+// object, so the producers and the consumer can run in different processes. Indexed like RingBuffer by a head and
+// a tail, but every slot carries a sequence number, so the producers claim slots without a lock and the consumer
+// reads the items in place. Only one consumer may consume at a time.
+template <typename ItemType>
+class SharedMemoryRing final {
+    static_assert(std::is_trivially_copyable_v<ItemType>, "Only trivially copyable items can be shared between processes");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory requires lock-free atomics");
+
+public:
+    // Creates the shared memory object, fails if it already exists. The object is unlinked by the destructor.
+    SharedMemoryRing(const std::string& name, const size_t capacity)
+        : m_name{ name }
+        , m_isOwner{ true }
+    {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+            throw std::runtime_error("SharedMemoryRing capacity must be a power of two");
+        }
+
+        const auto fd{ ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600) };
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Could not create shared memory " + name);
+        }
+
+        m_size = GetMappingSize(capacity);
+        if (::ftruncate(fd, static_cast<off_t>(m_size)) != 0) {
+            const auto error{ errno };
+            ::close(fd);
+            ::shm_unlink(name.c_str());
+            throw std::system_error(error, std::generic_category(), "Could not resize shared memory " + name);
+        }
+
+        try {
+            Map(fd);
+        } catch (...) {
+            ::shm_unlink(name.c_str());
+            throw;
+        }
+
+        m_header = new (m_memory) Header{};
+        m_header->itemSize = sizeof(ItemType);
+        m_header->itemAlignment = alignof(ItemType);
+        m_header->capacity = capacity;
+        for (size_t i = 0; i < capacity; ++i) {
+            new (&GetSlot(i)) Slot{ { i }, {} };
+        }
+
+        // the openers check the magic last
+        m_header->magic.store(MAGIC, std::memory_order_release);
+    }
+
+    // Opens a ring created by another process, fails if it was created for a different item layout.
+    explicit SharedMemoryRing(const std::string& name)
+        : m_name{ name }
+        , m_isOwner{ false }
+    {
+        const auto fd{ ::shm_open(name.c_str(), O_RDWR, 0600) };
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "Could not open shared memory " + name);
+        }
+
+        struct stat status { };
+        if (::fstat(fd, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(Header)) {
+            ::close(fd);
+            throw std::runtime_error("Shared memory " + name + " is not a ring");
+        }
+
+        m_size = static_cast<size_t>(status.st_size);
+        Map(fd);
+
+        m_header = std::launder(reinterpret_cast<Header*>(m_memory));
+        if (m_header->magic.load(std::memory_order_acquire) != MAGIC || m_header->itemSize != sizeof(ItemType) || m_header->itemAlignment != alignof(ItemType) || GetMappingSize(m_header->capacity) != m_size) {
+            ::munmap(m_memory, m_size);
+            throw std::runtime_error("Shared memory " + name + " is not a ring of the item type");
+        }
+    }
+
+    ~SharedMemoryRing()
+    {
+        ::munmap(m_memory, m_size);
+        if (m_isOwner) {
+            ::shm_unlink(m_name.c_str());
+        }
+    }
+
+public:
+    // Returns false if the ring is full.
+    bool TryPush(const ItemType& item)
+    {
+        auto position{ m_header->tail.load(std::memory_order_relaxed) };
+        while (true) {
+            auto& slot{ GetSlot(position) };
+            const auto difference{ static_cast<int64_t>(slot.sequence.load(std::memory_order_acquire) - position) };
+            if (difference == 0) {
+                if (m_header->tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    std::memcpy(&slot.storage, &item, sizeof(ItemType));
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = m_header->tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumes the items pushed before the call in place, the slot is returned to the producers after the consumer
+    // returns. Stops at a slot claimed but not yet written by a producer.
+    template <typename ConsumerType>
+    size_t ConsumeAll(ConsumerType&& consumer)
+    {
+        const auto tail{ m_header->tail.load(std::memory_order_acquire) };
+        const auto head{ m_header->head.load(std::memory_order_relaxed) };
+
+        auto position{ head };
+        while (position != tail) {
+            auto& slot{ GetSlot(position) };
+            if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+                break;
+            }
+
+            struct ReleaseGuard {
+                ~ReleaseGuard()
+                {
+                    slot.sequence.store(position + capacity, std::memory_order_release);
+                    header.head.store(++position, std::memory_order_relaxed);
+                }
+
+                Slot& slot;
+
+                Header& header;
+
+                uint64_t& position;
+
+                const uint64_t capacity;
+            } guard{ slot, *m_header, position, m_header->capacity };
+
+            consumer(*std::launder(reinterpret_cast<const ItemType*>(&slot.storage)));
+        }
+        return static_cast<size_t>(position - head);
+    }
+
+    bool IsEmpty() const
+    {
+        return m_header->head.load(std::memory_order_relaxed) == m_header->tail.load(std::memory_order_acquire);
+    }
+
+    size_t Capacity() const
+    {
+        return static_cast<size_t>(m_header->capacity);
+    }
+
+private:
+    static const inline uint64_t MAGIC{ 0x31474e4952485721 };
+
+    struct Header {
+        std::atomic<uint64_t> magic{ 0 };
+
+        uint64_t itemSize{ 0 };
+
+        uint64_t itemAlignment{ 0 };
+
+        uint64_t capacity{ 0 };
+
+        alignas(64) std::atomic<uint64_t> tail{ 0 };
+
+        alignas(64) std::atomic<uint64_t> head{ 0 };
+    };
+
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+
+        std::aligned_storage_t<sizeof(ItemType), alignof(ItemType)> storage;
+    };
+
+    static const inline size_t SLOTS_OFFSET{ (sizeof(Header) + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot) };
+
+private:
+    static size_t GetMappingSize(const uint64_t capacity)
+    {
+        return SLOTS_OFFSET + static_cast<size_t>(capacity) * sizeof(Slot);
+    }
+
+    void Map(const int fd)
+    {
+        const auto memory{ ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) };
+        const auto error{ errno };
+        ::close(fd);
+        if (memory == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), "Could not map shared memory " + m_name);
+        }
+        m_memory = static_cast<unsigned char*>(memory);
+    }
+
+    Slot& GetSlot(const uint64_t position)
+    {
+        const auto index{ static_cast<size_t>(position & (m_header->capacity - 1)) };
+        return *std::launder(reinterpret_cast<Slot*>(m_memory + SLOTS_OFFSET + index * sizeof(Slot)));
+    }
+
+private:
+    SharedMemoryRing(const SharedMemoryRing& other) = delete;
+
+    SharedMemoryRing& operator=(const SharedMemoryRing& other) = delete;
+
+    SharedMemoryRing(SharedMemoryRing&& other) = delete;
+
+    SharedMemoryRing& operator=(SharedMemoryRing&& other) = delete;
+
+private:
+    const std::string m_name;
+
+    const bool m_isOwner;
+
+    size_t m_size{ 0 };
+
+    unsigned char* m_memory{ nullptr };
+
+    Header* m_header{ nullptr };
+};
+} // namespace worm::detail
+
+#endif
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef __WH_SLOT_MAP_H__
+#define __WH_SLOT_MAP_H__
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace worm::detail {
+struct SlotHandle {
+    static const inline uint32_t INVALID_INDEX{ std::numeric_limits<uint32_t>::max() };
+
+    uint32_t index{ INVALID_INDEX };
+
+    uint32_t generation{ 0 };
+
+    bool IsValid() const
+    {
+        return index != INVALID_INDEX;
+    }
+
+    bool operator==(const SlotHandle& other) const
+    {
+        return index == other.index && generation == other.generation;
+    }
+
+    bool operator!=(const SlotHandle& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// Slot map with O(1) insertion/removal, generation checked handles and dense iteration.
+// Slots never move, so the generation of a slot can be read by lock-free readers while the map is being modified.
+// The map itself is not thread-safe.
+template <typename ValueType>
+class SlotMap final {
+public:
+    SlotMap() = default;
+
+    ~SlotMap() = default;
+
+public:
+    template <typename... Args>
+    SlotHandle Emplace(Args&&... args)
+    {
+        uint32_t index;
+        if (m_freeSlots.empty()) {
+            if (m_slotCount % BLOCK_SIZE == 0) {
+                m_blocks.emplace_back(std::make_unique<Slot[]>(BLOCK_SIZE));
+            }
+            index = m_slotCount++;
+        } else {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        }
+
+        auto& slot{ GetSlot(index) };
+        slot.value.emplace(std::forward<Args>(args)...);
+        slot.denseIndex = static_cast<uint32_t>(m_dense.size());
+        m_dense.push_back(index);
+
+        // odd generation means the slot is occupied
+        const auto generation{ slot.generation.load(std::memory_order_relaxed) + 1 };
+        slot.generation.store(generation, std::memory_order_release);
+        return { index, generation };
+    }
+
+    bool Erase(const SlotHandle& handle)
+    {
+        if (!Contains(handle)) {
+            return false;
+        }
+
+        auto& slot{ GetSlot(handle.index) };
+        slot.generation.store(handle.generation + 1, std::memory_order_seq_cst);
+        slot.value.reset();
+
+        const auto lastIndex{ m_dense.back() };
+        m_dense[slot.denseIndex] = lastIndex;
+        GetSlot(lastIndex).denseIndex = slot.denseIndex;
+        m_dense.pop_back();
+
+        m_freeSlots.push_back(handle.index);
+        return true;
+    }
+
+    bool Contains(const SlotHandle& handle) const
+    {
+        return handle.index < m_slotCount && GetSlot(handle.index).generation.load(std::memory_order_relaxed) == handle.generation;
+    }
+
+    ValueType* Get(const SlotHandle& handle)
+    {
+        return Contains(handle) ? &*GetSlot(handle.index).value : nullptr;
+    }
+
+    // Stable for the lifetime of the map, changes whenever the slot is occupied or released.
+    const std::atomic<uint32_t>& GetGeneration(const uint32_t index) const
+    {
+        return GetSlot(index).generation;
+    }
+
+    size_t Size() const
+    {
+        return m_dense.size();
+    }
+
+    template <typename VisitorType>
+    void ForEach(VisitorType&& visitor) const
+    {
+        for (const auto index : m_dense) {
+            const auto& slot{ GetSlot(index) };
+            visitor(SlotHandle{ index, slot.generation.load(std::memory_order_relaxed) }, *slot.value);
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> generation{ 0 };
+
+        uint32_t denseIndex{ 0 };
+
+        std::optional<ValueType> value;
+    };
+
+private:
+    Slot& GetSlot(const uint32_t index)
+    {
+        return m_blocks[index / BLOCK_SIZE][index % BLOCK_SIZE];
+    }
+
+    const Slot& GetSlot(const uint32_t index) const
+    {
+        return m_blocks[index / BLOCK_SIZE][index % BLOCK_SIZE];
+    }
+
+private:
+    SlotMap(const SlotMap& other) = delete;
+
+    SlotMap& operator=(const SlotMap& other) = delete;
+
+    SlotMap(SlotMap&& other) = delete;
+
+    SlotMap& operator=(SlotMap&& other) = delete;
+
+private:
+    static const inline uint32_t BLOCK_SIZE{ 256 };
+
+    std::vector<std::unique_ptr<Slot[]>> m_blocks;
+
+    uint32_t m_slotCount{ 0 };
+
+    std::vector<uint32_t> m_freeSlots;
+
+    std::vector<uint32_t> m_dense;
+};
+} // namespace worm::detail
+
+#endif
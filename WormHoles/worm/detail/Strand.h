@@ -0,0 +1,219 @@
+#ifndef __WH_STRAND_H__
+#define __WH_STRAND_H__
+
+#include "WorkStealingExecutor.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace worm::detail {
+// Runs items one after another on a shared executor - at most one item of a strand is processed at a time
+// so the items are handled in the order they were posted.
+// Items are constructed in place in a preallocated ring which only grows when the high-water mark is exceeded.
+template <typename ItemType>
+class Strand final {
+public:
+    using HandlerType = void (*)(void* context, ItemType& item);
+
+public:
+    Strand(WorkStealingExecutor& executor, HandlerType handler, void* context, const size_t initialCapacity = DEFAULT_CAPACITY)
+        : m_executor{ executor }
+        , m_handler{ handler }
+        , m_context{ context }
+        , m_items(RoundUpToPowerOfTwo(initialCapacity))
+    {
+    }
+
+    ~Strand()
+    {
+        std::unique_lock lock{ m_mutex };
+
+        m_idleCondition.wait(lock, [this]() { return !m_scheduled; });
+    }
+
+public:
+    // Nothing is posted if the construction of the item throws.
+    template <typename... Args>
+    void Emplace(Args&&... args)
+    {
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            if (m_size == m_items.size()) {
+                Grow();
+            }
+            m_items[(m_head + m_size) & (m_items.size() - 1)].emplace(std::forward<Args>(args)...);
+            ++m_size;
+            m_postedCount.fetch_add(1, std::memory_order_seq_cst);
+
+            if (m_scheduled) {
+                return;
+            }
+            m_scheduled = true;
+        }
+
+        m_executor.Submit({ &Strand::Run, this });
+    }
+
+    // The ticket of the items posted so far - they are handled once the completed count reaches it.
+    uint64_t GetTicket() const
+    {
+        return m_postedCount.load(std::memory_order_acquire);
+    }
+
+    // Blocks until all the items posted so far are handled, items posted meanwhile are not waited for.
+    void Wait()
+    {
+        Wait(GetTicket());
+    }
+
+    void Wait(const uint64_t ticket)
+    {
+        if (IsCompleted(ticket)) {
+            return;
+        }
+
+        std::unique_lock lock{ m_mutex };
+
+        m_waiterCount.fetch_add(1, std::memory_order_seq_cst);
+        m_idleCondition.wait(lock, [this, ticket]() { return IsCompleted(ticket); });
+        m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Returns false if the items posted so far are not handled by the deadline.
+    bool WaitUntil(const std::chrono::steady_clock::time_point deadline)
+    {
+        return WaitUntil(GetTicket(), deadline);
+    }
+
+    bool WaitUntil(const uint64_t ticket, const std::chrono::steady_clock::time_point deadline)
+    {
+        if (IsCompleted(ticket)) {
+            return true;
+        }
+
+        std::unique_lock lock{ m_mutex };
+
+        m_waiterCount.fetch_add(1, std::memory_order_seq_cst);
+        const auto isCompleted{ m_idleCondition.wait_until(lock, deadline, [this, ticket]() { return IsCompleted(ticket); }) };
+        m_waiterCount.fetch_sub(1, std::memory_order_relaxed);
+        return isCompleted;
+    }
+
+    size_t GetPendingCount() const
+    {
+        const auto completedCount{ m_completedCount.load(std::memory_order_acquire) };
+        return static_cast<size_t>(m_postedCount.load(std::memory_order_acquire) - completedCount);
+    }
+
+private:
+    static void Run(void* context)
+    {
+        auto& self{ *static_cast<Strand*>(context) };
+
+        for (size_t i = 0; i < MAX_BATCH_SIZE; ++i) {
+            std::optional<ItemType> item;
+            {
+                std::scoped_lock lock{ self.m_mutex };
+
+                if (self.m_size == 0) {
+                    self.m_scheduled = false;
+                    self.m_idleCondition.notify_all();
+                    return;
+                }
+
+                auto& slot{ self.m_items[self.m_head] };
+                item.emplace(std::move(*slot));
+                slot.reset();
+                self.m_head = (self.m_head + 1) & (self.m_items.size() - 1);
+                --self.m_size;
+            }
+
+            self.m_handler(self.m_context, *item);
+
+            self.m_completedCount.fetch_add(1, std::memory_order_seq_cst);
+            if (self.m_waiterCount.load(std::memory_order_seq_cst) > 0) {
+                std::scoped_lock lock{ self.m_mutex };
+
+                self.m_idleCondition.notify_all();
+            }
+        }
+
+        // give the other strands sharing the worker a chance to run
+        self.m_executor.Submit({ &Strand::Run, &self });
+    }
+
+    bool IsCompleted(const uint64_t ticket) const
+    {
+        return m_completedCount.load(std::memory_order_acquire) >= ticket;
+    }
+
+    void Grow()
+    {
+        std::vector<std::optional<ItemType>> items(m_items.size() * 2);
+        for (size_t i = 0; i < m_size; ++i) {
+            auto& slot{ m_items[(m_head + i) & (m_items.size() - 1)] };
+            items[i].emplace(std::move(*slot));
+            slot.reset();
+        }
+        m_items = std::move(items);
+        m_head = 0;
+    }
+
+    static size_t RoundUpToPowerOfTwo(const size_t value)
+    {
+        size_t result{ 1 };
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+private:
+    Strand(const Strand& other) = delete;
+
+    Strand& operator=(const Strand& other) = delete;
+
+    Strand(Strand&& other) = delete;
+
+    Strand& operator=(Strand&& other) = delete;
+
+private:
+    static const inline size_t DEFAULT_CAPACITY{ 64 };
+
+    static const inline size_t MAX_BATCH_SIZE{ 64 };
+
+    WorkStealingExecutor& m_executor;
+
+    HandlerType m_handler;
+
+    void* m_context;
+
+    std::mutex m_mutex;
+
+    std::condition_variable m_idleCondition;
+
+    std::vector<std::optional<ItemType>> m_items;
+
+    size_t m_head{ 0 };
+
+    size_t m_size{ 0 };
+
+    bool m_scheduled{ false };
+
+    // incremented under m_mutex once the item is stored
+    std::atomic<uint64_t> m_postedCount{ 0 };
+
+    std::atomic<uint64_t> m_completedCount{ 0 };
+
+    // the workers notify only while somebody waits
+    std::atomic<size_t> m_waiterCount{ 0 };
+};
+} // namespace worm::detail
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef __WH_TIMER_WHEEL_H__
+#define __WH_TIMER_WHEEL_H__
+
+#include "Construct.h"
+#include "SlotMap.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+namespace worm::detail {
+// Hierarchical timer wheel (Varghese & Lauck) - LEVEL_COUNT wheels of SLOT_COUNT slots, a slot of a level spans
+// a whole rotation of the level below. Scheduling and cancellation are O(1), a timer is moved down at most
+// LEVEL_COUNT - 1 times before it is due. Timers further than the top level are parked in its farthest slot
+// until they come closer. Ticks are abstract, the wheel is not thread-safe.
+template <typename ItemType>
+class TimerWheel final {
+public:
+    static const inline size_t LEVEL_BITS{ 8 };
+
+    static const inline size_t SLOT_COUNT{ size_t{ 1 } << LEVEL_BITS };
+
+    static const inline size_t LEVEL_COUNT{ 4 };
+
+public:
+    explicit TimerWheel(const uint64_t currentTick = 0)
+        : m_currentTick{ currentTick }
+    {
+    }
+
+    ~TimerWheel() = default;
+
+public:
+    // A timer due at the current tick or earlier is due right away.
+    template <typename... Args>
+    SlotHandle Schedule(const uint64_t tick, Args&&... args)
+    {
+        const auto handle{ m_timers.Emplace(tick, std::forward<Args>(args)...) };
+        Insert(handle, *m_timers.Get(handle));
+        return handle;
+    }
+
+    bool Cancel(const SlotHandle& handle)
+    {
+        const auto timer{ m_timers.Get(handle) };
+        if (!timer) {
+            return false;
+        }
+
+        Unlink(*timer);
+        m_timers.Erase(handle);
+        return true;
+    }
+
+    // Moves the timers due up to the tick to the due list, returns the number of due timers.
+    // Ticks which would neither cascade nor fire any timer are skipped.
+    size_t Advance(const uint64_t tick)
+    {
+        while (m_currentTick < tick) {
+            size_t emptyLevelCount{ 0 };
+            while (emptyLevelCount < LEVEL_COUNT && m_counts[emptyLevelCount] == 0) {
+                ++emptyLevelCount;
+            }
+
+            if (emptyLevelCount > 0) {
+                // the next tick cascading the first non-empty level
+                const auto span{ uint64_t{ 1 } << (LEVEL_BITS * std::min(emptyLevelCount, LEVEL_COUNT - 1)) };
+                const auto nextCascadeTick{ (m_currentTick / span + 1) * span };
+                if (emptyLevelCount == LEVEL_COUNT || nextCascadeTick > tick) {
+                    m_currentTick = tick;
+                    break;
+                }
+                m_currentTick = nextCascadeTick - 1;
+            }
+
+            ++m_currentTick;
+
+            // a higher level first, its timers might move to the slot of the lower one
+            for (auto level{ LEVEL_COUNT - 1 }; level > 0; --level) {
+                if ((m_currentTick & ((uint64_t{ 1 } << (LEVEL_BITS * level)) - 1)) == 0) {
+                    Reinsert(m_wheels[level][GetSlotIndex(m_currentTick, level)]);
+                }
+            }
+            Reinsert(m_wheels[0][GetSlotIndex(m_currentTick, 0)]);
+        }
+        return m_counts[LEVEL_COUNT];
+    }
+
+    // Due timers in the order of their ticks.
+    std::optional<ItemType> PopDue()
+    {
+        if (!m_dueTimers.head.IsValid()) {
+            return std::nullopt;
+        }
+
+        const auto handle{ m_dueTimers.head };
+        auto& timer{ *m_timers.Get(handle) };
+        Unlink(timer);
+
+        std::optional<ItemType> item{ std::move(timer.item) };
+        m_timers.Erase(handle);
+        return item;
+    }
+
+    size_t Size() const
+    {
+        return m_timers.Size();
+    }
+
+    uint64_t GetCurrentTick() const
+    {
+        return m_currentTick;
+    }
+
+private:
+    struct TimerList {
+        SlotHandle head;
+
+        SlotHandle tail;
+    };
+
+    struct Timer {
+        template <typename... Args>
+        explicit Timer(const uint64_t dueTick, Args&&... args)
+            : item(Construct<ItemType>(std::forward<Args>(args)...))
+            , tick{ dueTick }
+        {
+        }
+
+        ItemType item;
+
+        uint64_t tick;
+
+        SlotHandle handle;
+
+        SlotHandle previous;
+
+        SlotHandle next;
+
+        TimerList* list{ nullptr };
+
+        // LEVEL_COUNT for the due list
+        size_t level{ 0 };
+    };
+
+private:
+    static size_t GetSlotIndex(const uint64_t tick, const size_t level)
+    {
+        return static_cast<size_t>((tick >> (LEVEL_BITS * level)) & (SLOT_COUNT - 1));
+    }
+
+    void Insert(const SlotHandle& handle, Timer& timer)
+    {
+        timer.handle = handle;
+
+        if (timer.tick <= m_currentTick) {
+            Append(m_dueTimers, LEVEL_COUNT, timer);
+            return;
+        }
+
+        const auto delta{ timer.tick - m_currentTick };
+        for (size_t level = 0; level < LEVEL_COUNT; ++level) {
+            if (delta < (uint64_t{ 1 } << (LEVEL_BITS * (level + 1)))) {
+                Append(m_wheels[level][GetSlotIndex(timer.tick, level)], level, timer);
+                return;
+            }
+        }
+
+        // the farthest slot of the top level, the timer is placed again once the slot comes around
+        const auto topLevel{ LEVEL_COUNT - 1 };
+        Append(m_wheels[topLevel][GetSlotIndex(m_currentTick + (uint64_t{ 1 } << (LEVEL_BITS * LEVEL_COUNT)) - 1, topLevel)], topLevel, timer);
+    }
+
+    void Reinsert(TimerList& list)
+    {
+        auto handle{ list.head };
+        list = {};
+
+        while (handle.IsValid()) {
+            auto& timer{ *m_timers.Get(handle) };
+            handle = timer.next;
+
+            --m_counts[timer.level];
+            Insert(timer.handle, timer);
+        }
+    }
+
+    void Append(TimerList& list, const size_t level, Timer& timer)
+    {
+        ++m_counts[level];
+        timer.level = level;
+        timer.list = &list;
+        timer.previous = list.tail;
+        timer.next = {};
+        if (list.tail.IsValid()) {
+            m_timers.Get(list.tail)->next = timer.handle;
+        } else {
+            list.head = timer.handle;
+        }
+        list.tail = timer.handle;
+    }
+
+    void Unlink(Timer& timer)
+    {
+        auto& list{ *timer.list };
+        if (timer.previous.IsValid()) {
+            m_timers.Get(timer.previous)->next = timer.next;
+        } else {
+            list.head = timer.next;
+        }
+        if (timer.next.IsValid()) {
+            m_timers.Get(timer.next)->previous = timer.previous;
+        } else {
+            list.tail = timer.previous;
+        }
+        timer.list = nullptr;
+        --m_counts[timer.level];
+    }
+
+private:
+    TimerWheel(const TimerWheel& other) = delete;
+
+    TimerWheel& operator=(const TimerWheel& other) = delete;
+
+    TimerWheel(TimerWheel&& other) = delete;
+
+    TimerWheel& operator=(TimerWheel&& other) = delete;
+
+private:
+    uint64_t m_currentTick;
+
+    SlotMap<Timer> m_timers;
+
+    TimerList m_wheels[LEVEL_COUNT][SLOT_COUNT]{};
+
+    TimerList m_dueTimers;
+
+    // timers per level, the last one counts the due timers
+    size_t m_counts[LEVEL_COUNT + 1]{};
+};
+} // namespace worm::detail
+
+#endif
@@ -0,0 +1,244 @@
+#ifndef __WH_WORK_STEALING_EXECUTOR_H__
+#define __WH_WORK_STEALING_EXECUTOR_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace worm::detail {
+class WorkStealingExecutor final {
+public:
+    struct Task {
+        void (*function)(void* context){ nullptr };
+
+        void* context{ nullptr };
+    };
+
+public:
+    explicit WorkStealingExecutor(const size_t workerCount)
+    {
+        SetWorkerCount(workerCount);
+    }
+
+    ~WorkStealingExecutor()
+    {
+        {
+            std::scoped_lock lock{ m_sleepMutex };
+            m_running = false;
+        }
+
+        m_sleepCondition.notify_all();
+
+        for (auto& worker : m_workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+public:
+    // Workers are started lazily on the first submission, the worker count can be changed only before that.
+    void SetWorkerCount(const size_t workerCount)
+    {
+        if (workerCount == 0) {
+            throw std::runtime_error("WorkStealingExecutor must have at least one worker");
+        }
+
+        std::scoped_lock lock{ m_startMutex };
+
+        if (m_started) {
+            throw std::runtime_error("WorkStealingExecutor worker count can not be changed after it has been started");
+        }
+
+        m_workers.clear();
+        for (size_t i = 0; i < workerCount; ++i) {
+            m_workers.emplace_back(std::make_unique<Worker>());
+        }
+    }
+
+    size_t GetWorkerCount() const
+    {
+        return m_workers.size();
+    }
+
+    void Submit(const Task& task)
+    {
+        if (!m_started.load(std::memory_order_acquire)) {
+            Start();
+        }
+
+        const auto index{ s_currentWorker.executor == this ? s_currentWorker.index : m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size() };
+        m_workers[index]->queue.PushBack(task);
+
+        m_pendingCount.fetch_add(1);
+
+        if (m_sleepingCount.load() > 0) {
+            {
+                std::scoped_lock lock{ m_sleepMutex };
+            }
+            m_sleepCondition.notify_one();
+        }
+    }
+
+private:
+    class WorkQueue final {
+    public:
+        void PushBack(const Task& task)
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            if (m_size == m_tasks.size()) {
+                Grow();
+            }
+            m_tasks[(m_head + m_size) & (m_tasks.size() - 1)] = task;
+            ++m_size;
+        }
+
+        bool PopFront(Task& task)
+        {
+            std::scoped_lock lock{ m_mutex };
+
+            if (m_size == 0) {
+                return false;
+            }
+            task = m_tasks[m_head];
+            m_head = (m_head + 1) & (m_tasks.size() - 1);
+            --m_size;
+            return true;
+        }
+
+    private:
+        void Grow()
+        {
+            std::vector<Task> tasks(m_tasks.size() * 2);
+            for (size_t i = 0; i < m_size; ++i) {
+                tasks[i] = m_tasks[(m_head + i) & (m_tasks.size() - 1)];
+            }
+            m_tasks = std::move(tasks);
+            m_head = 0;
+        }
+
+    private:
+        static const inline size_t INITIAL_CAPACITY{ 64 };
+
+        std::mutex m_mutex;
+
+        std::vector<Task> m_tasks = std::vector<Task>(INITIAL_CAPACITY);
+
+        size_t m_head{ 0 };
+
+        size_t m_size{ 0 };
+    };
+
+    struct alignas(64) Worker {
+        WorkQueue queue;
+
+        std::thread thread;
+    };
+
+    struct WorkerContext {
+        const WorkStealingExecutor* executor;
+
+        size_t index;
+    };
+
+private:
+    void Start()
+    {
+        std::scoped_lock lock{ m_startMutex };
+
+        if (m_started.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        for (size_t i = 0; i < m_workers.size(); ++i) {
+            m_workers[i]->thread = std::thread([this, i]() { Run(i); });
+        }
+
+        m_started.store(true, std::memory_order_release);
+    }
+
+    void Run(const size_t index)
+    {
+        s_currentWorker = { this, index };
+
+        Task task;
+        for (;;) {
+            if (TryPop(index, task)) {
+                m_pendingCount.fetch_sub(1);
+                task.function(task.context);
+                continue;
+            }
+
+            std::unique_lock lock{ m_sleepMutex };
+
+            ++m_sleepingCount;
+            m_sleepCondition.wait(lock, [this]() {
+                return !m_running || m_pendingCount.load() > 0;
+            });
+            --m_sleepingCount;
+
+            if (!m_running && m_pendingCount.load() == 0) {
+                break;
+            }
+        }
+
+        s_currentWorker = { nullptr, 0 };
+    }
+
+    // Unlike the usual LIFO owner, both the owner and the thieves take the oldest task. A strand resubmits itself after
+    // a batch to let the other strands of the worker run, a LIFO owner would pick it again right away, and a thief
+    // stealing the newest task would overtake the strands waiting longest.
+    bool TryPop(const size_t index, Task& task)
+    {
+        if (m_workers[index]->queue.PopFront(task)) {
+            return true;
+        }
+
+        // steal from the other workers
+        for (size_t i = 1; i < m_workers.size(); ++i) {
+            if (m_workers[(index + i) % m_workers.size()]->queue.PopFront(task)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    WorkStealingExecutor(const WorkStealingExecutor& other) = delete;
+
+    WorkStealingExecutor& operator=(const WorkStealingExecutor& other) = delete;
+
+    WorkStealingExecutor(WorkStealingExecutor&& other) = delete;
+
+    WorkStealingExecutor& operator=(WorkStealingExecutor&& other) = delete;
+
+private:
+    static inline thread_local WorkerContext s_currentWorker{ nullptr, 0 };
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    std::atomic<bool> m_started{ false };
+
+    std::mutex m_startMutex;
+
+    std::atomic<size_t> m_nextWorker{ 0 };
+
+    std::atomic<size_t> m_pendingCount{ 0 };
+
+    std::atomic<size_t> m_sleepingCount{ 0 };
+
+    bool m_running{ true };
+
+    std::mutex m_sleepMutex;
+
+    std::condition_variable m_sleepCondition;
+};
+} // namespace worm::detail
+
+#endif